@@ -7,6 +7,8 @@
 #include <string>
 #include <vector>
 #include <atomic>
+#include <mutex>
+#include <unordered_map>
 
 class ATMClient {
 private:
@@ -14,6 +16,7 @@ private:
     std::string server_host;
     int server_port;
     std::atomic<bool> connected;
+    FrameDecoder frame_decoder; // Reassembles responses split or merged by TCP
     
     // Session data
     std::string session_token;
@@ -24,6 +27,12 @@ private:
     // User accounts cache
     std::vector<int> user_accounts;
 
+    // Pipelining: requests carry an id and replies may arrive in any order
+    std::atomic<uint32_t> next_request_id;
+    std::mutex send_mutex;
+    std::mutex receive_mutex;
+    std::unordered_map<uint32_t, std::string> pending_responses; // request_id -> response
+
 public:
     ATMClient(const std::string& host = "localhost", int port = DEFAULT_BANK_PORT);
     ~ATMClient();
@@ -35,9 +44,14 @@ public:
     
     // ATM operations
     bool login(const std::string& email, const std::string& password);
-    bool checkBalance(int account_id, double& balance, std::string& account_type);
-    bool withdraw(int account_id, double amount, double& new_balance, std::string& transaction_id);
+    bool checkBalance(int account_id, Money& balance, std::string& account_type);
+    bool withdraw(int account_id, Money amount, Money& new_balance, std::string& transaction_id);
+    bool checkBalances(const std::vector<int>& account_ids, std::vector<BalanceResponse>& responses);
     bool logout();
+
+    // Pipelined requests (several may be in flight on one connection)
+    uint32_t submitRequest(const std::string& message);
+    std::string awaitResponse(uint32_t request_id);
     
     // User interface
     void run();
@@ -59,8 +73,8 @@ public:
     
 private:
     // Network communication
-    bool sendEncryptedMessage(const std::string& message);
-    std::string receiveEncryptedMessage();
+    bool sendEncryptedMessage(const std::string& message, uint32_t request_id);
+    std::string receiveEncryptedMessage(uint32_t& request_id);
     
     // Socket operations
     bool setupSocket();
@@ -69,7 +83,7 @@ private:
     // Input helpers
     std::string getSecureInput();
     int getIntInput();
-    double getDoubleInput();
+    Money getMoneyInput();
     
     // Error handling
     void handleNetworkError(const std::string& operation);
@@ -0,0 +1,61 @@
+#ifndef MONEY_H
+#define MONEY_H
+
+#include <cstdint>
+#include <string>
+#include <ostream>
+
+// Exact currency amount stored as a signed count of minor units (cents).
+// All balances and transaction amounts use Money so sums are exact and a
+// balance fits in a single 64-bit word. Conversion to double exists only for
+// legacy boundaries (REAL database columns) and is rounded to the nearest cent.
+class Money {
+private:
+    int64_t minor_units;
+
+    explicit constexpr Money(int64_t minor) : minor_units(minor) {}
+
+public:
+    static constexpr int64_t MINOR_UNITS_PER_MAJOR = 100;
+
+    constexpr Money() : minor_units(0) {}
+
+    // Factories
+    static constexpr Money fromMinorUnits(int64_t minor) { return Money(minor); }
+    static constexpr Money fromMajorUnits(int64_t major) { return Money(major * MINOR_UNITS_PER_MAJOR); }
+    static Money fromDouble(double amount);
+    // Exact decimal parse of "123", "-4.5" or "0.07"; fails on more than two decimals
+    static bool parse(const std::string& text, Money& result);
+
+    // Accessors
+    constexpr int64_t minorUnits() const { return minor_units; }
+    double toDouble() const { return static_cast<double>(minor_units) / MINOR_UNITS_PER_MAJOR; }
+    std::string toString() const; // Always two decimals, e.g. "1234.50"
+
+    constexpr bool isZero() const { return minor_units == 0; }
+    constexpr bool isNegative() const { return minor_units < 0; }
+    constexpr bool isPositive() const { return minor_units > 0; }
+
+    // Multiply by numerator/denominator, rounding half away from zero (used for interest)
+    Money multiplyRatio(int64_t numerator, int64_t denominator) const;
+
+    // Arithmetic
+    constexpr Money operator+(Money other) const { return Money(minor_units + other.minor_units); }
+    constexpr Money operator-(Money other) const { return Money(minor_units - other.minor_units); }
+    constexpr Money operator-() const { return Money(-minor_units); }
+    Money& operator+=(Money other) { minor_units += other.minor_units; return *this; }
+    Money& operator-=(Money other) { minor_units -= other.minor_units; return *this; }
+
+    // Comparison
+    constexpr bool operator==(Money other) const { return minor_units == other.minor_units; }
+    constexpr bool operator!=(Money other) const { return minor_units != other.minor_units; }
+    constexpr bool operator<(Money other) const { return minor_units < other.minor_units; }
+    constexpr bool operator<=(Money other) const { return minor_units <= other.minor_units; }
+    constexpr bool operator>(Money other) const { return minor_units > other.minor_units; }
+    constexpr bool operator>=(Money other) const { return minor_units >= other.minor_units; }
+};
+
+// Prints the amount with two decimals (no currency symbol)
+std::ostream& operator<<(std::ostream& os, const Money& amount);
+
+#endif // MONEY_H
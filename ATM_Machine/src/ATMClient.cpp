@@ -5,11 +5,17 @@
 #include <unistd.h>
 #include <iostream>
 #include <cstring>
+#include <cerrno>
 #include <random>
 #include <iomanip>
 
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // Not available on macOS; SIGPIPE stays at its default there
+#endif
+
 ATMClient::ATMClient(const std::string& host, int port) 
-    : server_host(host), server_port(port), connected(false), client_socket(-1), user_id(0) {
+    : server_host(host), server_port(port), connected(false), client_socket(-1), user_id(0),
+      next_request_id(1) {
     generateATMId();
 }
 
@@ -78,12 +84,13 @@ bool ATMClient::login(const std::string& email, const std::string& password) {
         std::string json_payload = JsonHandler::serializeLoginRequest(request);
         std::string network_message = JsonHandler::createNetworkMessage(MessageType::LOGIN_REQUEST, json_payload);
         
-        if (!sendEncryptedMessage(network_message)) {
+        uint32_t request_id = submitRequest(network_message);
+        if (request_id == 0) {
             std::cerr << "Failed to send login request" << std::endl;
             return false;
         }
         
-        std::string encrypted_response = receiveEncryptedMessage();
+        std::string encrypted_response = awaitResponse(request_id);
         if (encrypted_response.empty()) {
             std::cerr << "No response from server" << std::endl;
             return false;
@@ -112,7 +119,7 @@ bool ATMClient::login(const std::string& email, const std::string& password) {
 }
 
 // Check account balance
-bool ATMClient::checkBalance(int account_id, double& balance, std::string& account_type) {
+bool ATMClient::checkBalance(int account_id, Money& balance, std::string& account_type) {
     if (!connected || session_token.empty()) {
         std::cerr << "Not logged in" << std::endl;
         return false;
@@ -126,12 +133,13 @@ bool ATMClient::checkBalance(int account_id, double& balance, std::string& accou
         std::string json_payload = JsonHandler::serializeBalanceRequest(request);
         std::string network_message = JsonHandler::createNetworkMessage(MessageType::BALANCE_REQUEST, json_payload);
         
-        if (!sendEncryptedMessage(network_message)) {
+        uint32_t request_id = submitRequest(network_message);
+        if (request_id == 0) {
             std::cerr << "Failed to send balance request" << std::endl;
             return false;
         }
         
-        std::string encrypted_response = receiveEncryptedMessage();
+        std::string encrypted_response = awaitResponse(request_id);
         if (encrypted_response.empty()) {
             std::cerr << "No response from server" << std::endl;
             return false;
@@ -156,7 +164,7 @@ bool ATMClient::checkBalance(int account_id, double& balance, std::string& accou
 }
 
 // Withdraw money
-bool ATMClient::withdraw(int account_id, double amount, double& new_balance, std::string& transaction_id) {
+bool ATMClient::withdraw(int account_id, Money amount, Money& new_balance, std::string& transaction_id) {
     if (!connected || session_token.empty()) {
         std::cerr << "Not logged in" << std::endl;
         return false;
@@ -171,12 +179,13 @@ bool ATMClient::withdraw(int account_id, double amount, double& new_balance, std
         std::string json_payload = JsonHandler::serializeWithdrawRequest(request);
         std::string network_message = JsonHandler::createNetworkMessage(MessageType::WITHDRAW_REQUEST, json_payload);
 
-        if (!sendEncryptedMessage(network_message)) {
+        uint32_t request_id = submitRequest(network_message);
+        if (request_id == 0) {
             std::cerr << "Failed to send withdraw request" << std::endl;
             return false;
         }
 
-        std::string encrypted_response = receiveEncryptedMessage();
+        std::string encrypted_response = awaitResponse(request_id);
         if (encrypted_response.empty()) {
             std::cerr << "No response from server" << std::endl;
             return false;
@@ -200,6 +209,55 @@ bool ATMClient::withdraw(int account_id, double amount, double& new_balance, std
     }
 }
 
+// Check several balances with all requests in flight at once
+bool ATMClient::checkBalances(const std::vector<int>& account_ids, std::vector<BalanceResponse>& responses) {
+    responses.clear();
+    if (!connected || session_token.empty()) {
+        std::cerr << "Not logged in" << std::endl;
+        return false;
+    }
+
+    try {
+        // Send every request before reading any reply
+        std::vector<uint32_t> request_ids;
+        request_ids.reserve(account_ids.size());
+        for (int account_id : account_ids) {
+            BalanceRequest request;
+            request.session_token = session_token;
+            request.account_id = account_id;
+
+            std::string json_payload = JsonHandler::serializeBalanceRequest(request);
+            uint32_t request_id = submitRequest(
+                JsonHandler::createNetworkMessage(MessageType::BALANCE_REQUEST, json_payload));
+            if (request_id == 0) {
+                std::cerr << "Failed to send balance request" << std::endl;
+                return false;
+            }
+            request_ids.push_back(request_id);
+        }
+
+        // Collect replies in request order, whatever order they arrive in
+        bool all_succeeded = true;
+        for (uint32_t request_id : request_ids) {
+            std::string encrypted_response = awaitResponse(request_id);
+            if (encrypted_response.empty()) {
+                std::cerr << "No response from server" << std::endl;
+                return false;
+            }
+
+            NetworkMessage net_msg = JsonHandler::parseNetworkMessage(encrypted_response);
+            responses.push_back(JsonHandler::deserializeBalanceResponse(net_msg.payload));
+            all_succeeded = all_succeeded && responses.back().success;
+        }
+
+        return all_succeeded;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Balance check error: " << e.what() << std::endl;
+        return false;
+    }
+}
+
 // Logout
 bool ATMClient::logout() {
     if (!connected || session_token.empty()) {
@@ -213,12 +271,13 @@ bool ATMClient::logout() {
         std::string json_payload = JsonHandler::serializeLogoutRequest(request);
         std::string network_message = JsonHandler::createNetworkMessage(MessageType::LOGOUT_REQUEST, json_payload);
 
-        if (!sendEncryptedMessage(network_message)) {
+        uint32_t request_id = submitRequest(network_message);
+        if (request_id == 0) {
             std::cerr << "Failed to send logout request" << std::endl;
             return false;
         }
 
-        std::string encrypted_response = receiveEncryptedMessage();
+        std::string encrypted_response = awaitResponse(request_id);
         if (!encrypted_response.empty()) {
             NetworkMessage net_msg = JsonHandler::parseNetworkMessage(encrypted_response);
             LogoutResponse response = JsonHandler::deserializeLogoutResponse(net_msg.payload);
@@ -323,7 +382,7 @@ void ATMClient::handleBalanceCheck() {
     std::cout << "Enter account number to check balance: ";
     int account_id = getIntInput();
 
-    double balance;
+    Money balance;
     std::string account_type;
 
     std::cout << "Checking balance..." << std::endl;
@@ -331,7 +390,7 @@ void ATMClient::handleBalanceCheck() {
         std::cout << "\n=== Balance Information ===" << std::endl;
         std::cout << "Account ID: " << account_id << std::endl;
         std::cout << "Account Type: " << account_type << std::endl;
-        std::cout << "Current Balance: $" << std::fixed << std::setprecision(2) << balance << std::endl;
+        std::cout << "Current Balance: $" << balance << std::endl;
         std::cout << "=========================" << std::endl;
     } else {
         std::cout << "Failed to retrieve balance. Please try again." << std::endl;
@@ -346,21 +405,21 @@ void ATMClient::handleWithdraw() {
     int account_id = getIntInput();
 
     std::cout << "Enter withdrawal amount: $";
-    double amount = getDoubleInput();
+    Money amount = getMoneyInput();
 
-    if (amount <= 0) {
+    if (!amount.isPositive()) {
         std::cout << "Invalid amount. Please enter a positive value." << std::endl;
         return;
     }
 
-    double new_balance;
+    Money new_balance;
     std::string transaction_id;
 
     std::cout << "Processing withdrawal..." << std::endl;
     if (withdraw(account_id, amount, new_balance, transaction_id)) {
         std::cout << "\n=== Withdrawal Successful ===" << std::endl;
-        std::cout << "Amount Withdrawn: $" << std::fixed << std::setprecision(2) << amount << std::endl;
-        std::cout << "New Balance: $" << std::fixed << std::setprecision(2) << new_balance << std::endl;
+        std::cout << "Amount Withdrawn: $" << amount << std::endl;
+        std::cout << "New Balance: $" << new_balance << std::endl;
         std::cout << "Transaction ID: " << transaction_id << std::endl;
         std::cout << "Please take your cash." << std::endl;
         std::cout << "============================" << std::endl;
@@ -415,25 +474,90 @@ void ATMClient::cleanupSocket() {
         close(client_socket);
         client_socket = -1;
     }
+    frame_decoder.reset();
+
+    std::lock_guard<std::mutex> lock(receive_mutex);
+    pending_responses.clear();
+}
+
+// Send a request without waiting for its response; returns its request id (0 on failure)
+uint32_t ATMClient::submitRequest(const std::string& message) {
+    uint32_t request_id = next_request_id++;
+    if (request_id == 0) {
+        request_id = next_request_id++; // 0 is reserved for non-pipelined clients
+    }
+
+    std::lock_guard<std::mutex> lock(send_mutex);
+    return sendEncryptedMessage(message, request_id) ? request_id : 0;
+}
+
+// Wait for the response to a submitted request.
+// Responses for other in-flight requests that arrive first are kept for their callers.
+std::string ATMClient::awaitResponse(uint32_t request_id) {
+    while (true) {
+        std::lock_guard<std::mutex> lock(receive_mutex);
+
+        auto it = pending_responses.find(request_id);
+        if (it != pending_responses.end()) {
+            std::string response = std::move(it->second);
+            pending_responses.erase(it);
+            return response;
+        }
+
+        uint32_t received_id = 0;
+        std::string response = receiveEncryptedMessage(received_id);
+        if (response.empty()) {
+            return ""; // Connection lost
+        }
+
+        if (received_id == request_id) {
+            return response;
+        }
+        pending_responses[received_id] = std::move(response);
+    }
 }
 
 // Network communication
-bool ATMClient::sendEncryptedMessage(const std::string& message) {
-    std::string encrypted = Encryption::encryptAndEncode(message);
-    ssize_t bytes_sent = send(client_socket, encrypted.c_str(), encrypted.length(), 0);
-    return bytes_sent == static_cast<ssize_t>(encrypted.length());
+bool ATMClient::sendEncryptedMessage(const std::string& message, uint32_t request_id) {
+    std::string frame = encodeFrame(Encryption::encryptAndEncode(message), request_id);
+
+    size_t total_sent = 0;
+    while (total_sent < frame.length()) {
+        ssize_t bytes_sent = send(client_socket, frame.data() + total_sent,
+                                  frame.length() - total_sent, MSG_NOSIGNAL);
+        if (bytes_sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes_sent <= 0) {
+            return false;
+        }
+        total_sent += static_cast<size_t>(bytes_sent);
+    }
+    return true;
 }
 
-std::string ATMClient::receiveEncryptedMessage() {
-    char buffer[MAX_MESSAGE_SIZE];
-    memset(buffer, 0, sizeof(buffer));
+std::string ATMClient::receiveEncryptedMessage(uint32_t& request_id) {
+    std::string encrypted;
+
+    // Keep reading until a whole frame has arrived
+    while (!frame_decoder.nextFrame(encrypted, request_id)) {
+        if (frame_decoder.isCorrupted()) {
+            std::cerr << "Malformed frame from server" << std::endl;
+            return "";
+        }
+
+        char buffer[RECV_BUFFER_SIZE];
+        ssize_t bytes_received = recv(client_socket, buffer, sizeof(buffer), 0);
+        if (bytes_received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes_received <= 0) {
+            return "";
+        }
 
-    ssize_t bytes_received = recv(client_socket, buffer, sizeof(buffer) - 1, 0);
-    if (bytes_received <= 0) {
-        return "";
+        frame_decoder.append(buffer, bytes_received);
     }
 
-    std::string encrypted(buffer, bytes_received);
     return Encryption::decodeAndDecrypt(encrypted);
 }
 
@@ -451,10 +575,15 @@ int ATMClient::getIntInput() {
     return value;
 }
 
-double ATMClient::getDoubleInput() {
-    double value;
-    std::cin >> value;
+Money ATMClient::getMoneyInput() {
+    std::string input;
+    std::cin >> input;
     std::cin.ignore(); // Clear newline
+
+    Money value;
+    if (!Money::parse(input, value)) {
+        return Money(); // Rejected by the caller as a non-positive amount
+    }
     return value;
 }
 
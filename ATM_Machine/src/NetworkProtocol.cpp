@@ -42,3 +42,78 @@ std::string getCurrentTimestamp() {
     ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
     return ss.str();
 }
+
+// Append a 32-bit value in network byte order
+static void appendUint32(std::string& out, uint32_t value) {
+    out.push_back(static_cast<char>((value >> 24) & 0xFF));
+    out.push_back(static_cast<char>((value >> 16) & 0xFF));
+    out.push_back(static_cast<char>((value >> 8) & 0xFF));
+    out.push_back(static_cast<char>(value & 0xFF));
+}
+
+// Read a 32-bit value in network byte order
+static uint32_t readUint32(const unsigned char* data) {
+    return (static_cast<uint32_t>(data[0]) << 24) |
+           (static_cast<uint32_t>(data[1]) << 16) |
+           (static_cast<uint32_t>(data[2]) << 8) |
+           static_cast<uint32_t>(data[3]);
+}
+
+// Prefix a payload with its frame header
+std::string encodeFrame(const std::string& payload, uint32_t request_id) {
+    std::string frame;
+    frame.reserve(FRAME_HEADER_SIZE + payload.size());
+    appendUint32(frame, static_cast<uint32_t>(payload.size()));
+    appendUint32(frame, request_id);
+    frame += payload;
+    return frame;
+}
+
+// FrameDecoder constructor
+FrameDecoder::FrameDecoder() : read_offset(0), corrupted(false) {}
+
+// Append received bytes to the reassembly buffer
+void FrameDecoder::append(const char* data, size_t length) {
+    // Reclaim consumed space before growing the buffer
+    if (read_offset > 0 && read_offset >= buffer.size() / 2) {
+        buffer.erase(0, read_offset);
+        read_offset = 0;
+    }
+    buffer.append(data, length);
+}
+
+// Extract the next complete frame, if one is buffered
+bool FrameDecoder::nextFrame(std::string& payload, uint32_t& request_id) {
+    if (corrupted || bufferedBytes() < FRAME_HEADER_SIZE) {
+        return false;
+    }
+
+    const unsigned char* header = reinterpret_cast<const unsigned char*>(buffer.data() + read_offset);
+    uint32_t length = readUint32(header);
+
+    if (length > MAX_FRAME_SIZE) {
+        corrupted = true; // Peer is not speaking the framed protocol
+        return false;
+    }
+
+    if (bufferedBytes() < FRAME_HEADER_SIZE + length) {
+        return false; // Wait for the rest of the frame
+    }
+
+    request_id = readUint32(header + 4);
+    payload.assign(buffer, read_offset + FRAME_HEADER_SIZE, length);
+    read_offset += FRAME_HEADER_SIZE + length;
+
+    if (read_offset == buffer.size()) {
+        buffer.clear();
+        read_offset = 0;
+    }
+    return true;
+}
+
+// Discard all buffered data
+void FrameDecoder::reset() {
+    buffer.clear();
+    read_offset = 0;
+    corrupted = false;
+}
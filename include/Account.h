@@ -5,21 +5,32 @@
 #include <mutex>
 #include <memory>
 #include <vector>
+#include <atomic>
+#include <cstdint>
 #include "Common.h"
 
 class Account {
 private:
     int account_id;
     int user_id;
-    double balance;
+    // Balance in minor units, updated with CAS so deposits and withdrawals need no lock.
+    // CLOSED_BALANCE marks a closed account and makes every credit and debit fail.
+    std::atomic<int64_t> balance_minor;
+    std::atomic<uint64_t> version; // Bumped after every committed balance change
     AccountType account_type;
-    mutable std::mutex account_mutex;
+    mutable std::mutex account_mutex; // Orders multi-account transfers only
     std::string created_at;
 
+    static constexpr int64_t CLOSED_BALANCE = INT64_MIN;
+
+    bool tryCredit(Money amount);
+    bool tryDebit(Money amount);
+    void refundDebit(Money amount); // Undo a transfer's debit (caller holds account_mutex)
+
 public:
     // Constructors
     Account();
-    Account(int account_id, int user_id, double initial_balance, AccountType type);
+    Account(int account_id, int user_id, Money initial_balance, AccountType type);
     
     // Destructor
     ~Account();
@@ -35,24 +46,29 @@ public:
     // Getters
     int getAccountId() const;
     int getUserId() const;
-    double getBalance() const;
+    Money getBalance() const;
     AccountType getAccountType() const;
+    uint64_t getVersion() const;
     std::string getCreatedAt() const;
 
     // Setters
     void setAccountId(int id);
     void setUserId(int user_id);
     void setAccountType(AccountType type);
-    void setBalance(double new_balance);
+    void setBalance(Money new_balance);
 
     // Core banking operations
-    TransactionStatus deposit(double amount);
-    TransactionStatus withdraw(double amount);
-    TransactionStatus transfer(std::shared_ptr<Account> to_account, double amount);
+    TransactionStatus deposit(Money amount);
+    TransactionStatus withdraw(Money amount);
+    TransactionStatus transfer(std::shared_ptr<Account> to_account, Money amount);
+    // One optimistic attempt; PENDING means another transfer got in first and it should be retried
+    TransactionStatus transferOptimistic(std::shared_ptr<Account> to_account, Money amount);
 
     // Balance operations
-    bool hasSufficientBalance(double amount) const;
-    void updateBalance(double new_balance);
+    bool hasSufficientBalance(Money amount) const;
+    void updateBalance(Money new_balance);
+    bool close(); // Succeeds only while the balance is zero
+    bool isClosed() const;
 
     // Locking mechanisms
     void lock() const;
@@ -61,16 +77,17 @@ public:
     std::mutex& getMutex() const;
 
     // Validation methods
-    static bool isValidAmount(double amount);
-    bool canWithdraw(double amount) const;
+    static bool isValidAmount(Money amount);
+    bool canWithdraw(Money amount) const;
 
     // Display methods
     void displayAccountInfo() const;
     std::string getAccountTypeString() const;
 
     // Interest calculation (for savings accounts)
-    double calculateInterest(double rate, int days) const;
+    Money calculateInterest(double rate, int days) const;
     void applyInterest(double rate);
+    bool postInterest(Money interest); // Credit computed interest; not subject to deposit limits
 
     // Transaction history
     std::vector<int> getTransactionHistory() const;
@@ -5,11 +5,71 @@
 #include "NetworkProtocol.h"
 #include "JsonHandler.h"
 #include "Encryption.h"
+#include "ThreadPool.h"
+#include "SessionStore.h"
 #include <thread>
 #include <vector>
 #include <unordered_map>
 #include <mutex>
 #include <atomic>
+#include <memory>
+#include <deque>
+#include <functional>
+#include <string>
+
+// How the server multiplexes ATM connections
+enum class ServerMode {
+    THREAD_PER_CLIENT,  // One dedicated thread per connected ATM
+    EPOLL_REACTOR       // Edge-triggered epoll I/O threads feeding the worker pool
+};
+
+struct IoLoop;
+
+// Connection state shared between the thread reading a socket and the workers
+// answering its (possibly pipelined) requests.
+// The socket is closed when the last reference goes away, so a worker that is
+// still replying can never write to a recycled descriptor.
+struct ClientConnection : public std::enable_shared_from_this<ClientConnection> {
+    int socket;
+    std::mutex write_mutex;
+    std::atomic<bool> closed; // Replies still queued are dropped (write failed, bad input or server stopping)
+    FrameDecoder decoder; // Only touched by the owning reader thread
+
+    // Reactor mode: workers never block on the socket. Replies the socket cannot take
+    // yet wait in output and the owning I/O thread flushes them on EPOLLOUT.
+    IoLoop* loop;                 // Owning I/O thread (null in thread-per-client mode)
+    std::string output;           // Encoded replies not yet sent (write_mutex)
+    bool peer_closed;             // Client half-closed; close once every reply is out (write_mutex)
+    std::atomic<size_t> in_flight; // Requests handed to the worker pool and not yet answered
+
+    // Reactor mode: id-0 requests come from clients that expect answers in order,
+    // so one worker task at a time drains them, as handleClient does inline
+    std::mutex ordered_mutex;
+    std::deque<std::string> ordered_requests; // ordered_mutex
+    bool ordered_running;                     // A drain task is queued or running (ordered_mutex)
+
+    // Reactor mode, owning I/O thread only
+    std::deque<std::function<void()>> backlog; // Requests the worker pool had no room for
+    bool registered;   // Still in the epoll set
+    bool read_paused;  // Reading stopped until the backlog and output drain
+    bool want_write;   // EPOLLOUT is armed
+
+    explicit ClientConnection(int socket)
+        : socket(socket), closed(false), loop(nullptr), peer_closed(false), in_flight(0),
+          ordered_running(false), registered(false), read_paused(false), want_write(false) {}
+    ~ClientConnection();
+};
+
+// One epoll instance serviced by a single I/O thread
+struct IoLoop {
+    int epoll_fd = -1;
+    int wake_fd = -1;
+    std::thread thread;
+
+    std::mutex pending_mutex;
+    std::vector<std::shared_ptr<ClientConnection>> pending; // Connections whose replies need this thread
+    std::vector<std::shared_ptr<ClientConnection>> paused;  // I/O thread only: reading is paused
+};
 
 class BankServer {
 private:
@@ -17,25 +77,38 @@ private:
     int server_socket;
     int port;
     std::atomic<bool> running;
+    std::atomic<bool> stop_requested; // Set once by stop(), which may run in a signal handler
     std::vector<std::thread> client_threads;
     
-    // Session management (using vectors to avoid linker issues)
-    std::vector<std::pair<std::string, int>> active_sessions; // token -> user_id
-    std::vector<std::pair<std::string, std::string>> session_atm_map; // token -> atm_id
-    std::mutex session_mutex;
+    // Session management (sharded, expires after SESSION_TIMEOUT_HOURS)
+    SessionStore sessions;
     
     // Client connection tracking
     std::vector<int> client_sockets;
     std::mutex client_mutex;
 
+    // Worker pool and reactor mode state
+    ServerMode mode;
+    size_t io_thread_count;
+    size_t worker_thread_count;
+    std::vector<std::unique_ptr<IoLoop>> io_loops;
+    std::unique_ptr<ThreadPool> worker_pool;
+    std::unordered_map<int, std::shared_ptr<ClientConnection>> connections; // socket -> connection
+    size_t next_io_loop;
+
 public:
-    explicit BankServer(int port = DEFAULT_BANK_PORT);
+    explicit BankServer(int port = DEFAULT_BANK_PORT, ServerMode mode = ServerMode::THREAD_PER_CLIENT);
     ~BankServer();
     
     // Server lifecycle
     bool start();
     void stop();
     bool isRunning() const { return running; }
+
+    // Reactor configuration (takes effect on the next start())
+    void setIoThreadCount(size_t count);
+    void setWorkerThreadCount(size_t count);
+    ServerMode getMode() const { return mode; }
     
     // Client handling
     void handleClient(int client_socket);
@@ -49,9 +122,10 @@ public:
     
     // Session management
     std::string createSession(int user_id, const std::string& atm_id);
+    bool lookupSession(const std::string& token, SessionInfo& info);
     bool validateSession(const std::string& token);
     int getUserIdFromSession(const std::string& token);
-    void removeSession(const std::string& token);
+    bool removeSession(const std::string& token);
     
     // Utility methods
     void broadcastMessage(const std::string& message);
@@ -62,8 +136,33 @@ private:
     // Socket operations
     bool setupSocket();
     void cleanupSocket();
-    std::string receiveMessage(int client_socket);
-    bool sendMessage(int client_socket, const std::string& message);
+    void teardown();
+    bool receiveData(int client_socket, FrameDecoder& decoder);
+    bool sendMessage(int client_socket, const std::string& payload, uint32_t request_id = 0);
+
+    // Request processing shared by both server modes
+    std::string buildResponse(const std::string& encrypted_message);
+    void dispatchMessage(const std::shared_ptr<ClientConnection>& connection,
+                         std::string encrypted_message, uint32_t request_id);
+    void sendResponse(const std::shared_ptr<ClientConnection>& connection,
+                      const std::string& response, uint32_t request_id);
+
+    // Reactor mode
+    bool startReactor();
+    void stopReactor();
+    void acceptReactorClient(int client_socket);
+    void runIoLoop(IoLoop* loop);
+    void readFromConnection(IoLoop* loop, ClientConnection* connection);
+    void queueRequest(ClientConnection* connection, std::string encrypted_message, uint32_t request_id);
+    void drainOrderedRequests(const std::shared_ptr<ClientConnection>& connection);
+    bool submitBacklog(ClientConnection* connection);
+    void resumePausedConnections(IoLoop* loop);
+    void queueReply(const std::shared_ptr<ClientConnection>& connection,
+                    const std::string& response, uint32_t request_id);
+    void wakeIoLoop(IoLoop* loop, const std::shared_ptr<ClientConnection>& connection);
+    void flushOutput(IoLoop* loop, ClientConnection* connection);
+    void updateEvents(IoLoop* loop, ClientConnection* connection);
+    void closeConnection(IoLoop* loop, ClientConnection* connection);
     
     // Error handling
     std::string createErrorResponse(const std::string& error_code, const std::string& error_message);
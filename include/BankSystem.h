@@ -5,14 +5,19 @@
 #include <vector>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
 #include <thread>
+#include <atomic>
 #include <condition_variable>
 #include "User.h"
 #include "Account.h"
 #include "Transaction.h"
 #include "DatabaseHandler.h"
 #include "DeadlockPrevention.h"
+#include "TransactionJournal.h"
+#include "InterestEngine.h"
+#include "WorkStealingScheduler.h"
 
 class BankSystem {
 private:
@@ -21,9 +26,11 @@ private:
     
     DatabaseHandler& db_handler;
     DeadlockPrevention deadlock_manager;
+    TransactionJournal journal; // Durable record of every committed transaction
     
     // In-memory caches for performance
     std::unordered_map<int, std::shared_ptr<User>> user_cache;
+    // Authoritative copy of account state: read-through on miss, write-through on update
     std::unordered_map<int, std::shared_ptr<Account>> account_cache;
 
     // Transaction cache for immediate history access
@@ -31,16 +38,38 @@ private:
     
     mutable std::mutex system_mutex;
     mutable std::mutex user_cache_mutex;
-    mutable std::mutex account_cache_mutex;
+    mutable std::shared_mutex account_cache_mutex;
+
+    // Ownership index: account_id -> user_id, so access checks never hit the database
+    std::unordered_map<int, int> account_owners;
+    mutable std::shared_mutex account_owner_mutex;
+    std::mutex transaction_cache_mutex;
+
+    // Background balance writer: hot paths only mark an account dirty, and the writer
+    // persists the latest balance, so many updates to one account cost one write
+    std::unordered_map<int, std::shared_ptr<Account>> dirty_accounts;
+    std::mutex dirty_mutex;
+    std::condition_variable dirty_cv;
+    std::thread balance_writer;
+    bool balance_writer_stopping;
+    // Held while balances are read and committed, so interest posting and the
+    // balance writer never commit balances out of order
+    std::mutex balance_write_mutex;
+
+    // Runs batches from processTransactionsConcurrently; started on first use
+    std::unique_ptr<WorkStealingScheduler> transaction_scheduler;
+    std::mutex scheduler_mutex;
     
-    // Current logged-in user
+    // Current logged-in user (interactive CLI only; server requests pass a user id)
     std::shared_ptr<User> current_user;
+
+    std::atomic<bool> initialized;
     
     // System statistics
     int total_users;
     int total_accounts;
-    int total_transactions;
-    double total_system_balance;
+    std::atomic<int> total_transactions;
+    Money total_system_balance;
 
     // Private constructor for singleton
     BankSystem();
@@ -64,25 +93,36 @@ public:
     bool registerUser(const std::string& name, const std::string& email, const std::string& password);
     bool loginUser(const std::string& email, const std::string& password);
     bool authenticateUser(const std::string& email, const std::string& password);
+    std::shared_ptr<User> authenticate(const std::string& email, const std::string& password);
     void logoutUser();
     bool logout(); // Alias for logoutUser for compatibility
     std::shared_ptr<User> getCurrentUser() const;
     bool isUserLoggedIn() const;
 
     // Account management
-    int createAccount(AccountType type, double initial_balance = 0.0);
+    int createAccount(AccountType type, Money initial_balance = Money());
+    int createAccount(int user_id, AccountType type, Money initial_balance = Money());
     std::shared_ptr<Account> getAccount(int account_id);
     std::vector<std::shared_ptr<Account>> getUserAccounts();
     std::vector<std::shared_ptr<Account>> getUserAccounts(int user_id);
     bool deleteAccount(int account_id);
+    bool deleteAccount(int user_id, int account_id);
+
+    // Banking operations (logged-in user)
+    bool deposit(int account_id, Money amount);
+    bool withdraw(int account_id, Money amount);
+    bool transfer(int from_account_id, int to_account_id, Money amount);
 
-    // Banking operations
-    bool deposit(int account_id, double amount);
-    bool withdraw(int account_id, double amount);
-    bool transfer(int from_account_id, int to_account_id, double amount);
+    // Session-scoped banking operations (explicit caller identity, never touch current_user)
+    bool deposit(int user_id, int account_id, Money amount);
+    bool withdraw(int user_id, int account_id, Money amount);
+    bool transfer(int user_id, int from_account_id, int to_account_id, Money amount);
     
     // Transaction history
     std::vector<std::shared_ptr<Transaction>> getAccountTransactions(int account_id);
+    std::vector<std::shared_ptr<Transaction>> getAccountTransactions(int user_id, int account_id);
+    TransactionPage getAccountTransactionPage(int account_id, int limit, const std::string& cursor = "");
+    TransactionPage getAccountTransactionPage(int user_id, int account_id, int limit, const std::string& cursor = "");
     std::vector<std::shared_ptr<Transaction>> getUserTransactions();
     std::vector<std::shared_ptr<Transaction>> getUserTransactions(int user_id);
 
@@ -98,18 +138,21 @@ public:
     // Cache management
     void refreshUserCache();
     void refreshAccountCache();
+    void invalidateAccount(int account_id);
     void clearCaches();
 
     // Validation methods
-    bool validateAccountOwnership(int account_id, int user_id) const;
-    bool accountExists(int account_id) const;
+    bool validateAccountOwnership(int account_id, int user_id);
+    bool accountExists(int account_id);
     bool userExists(int user_id) const;
 
-    // Concurrent operation support
-    void processTransactionsConcurrently(const std::vector<std::shared_ptr<Transaction>>& transactions);
+    // Concurrent operation support: returns one status per transaction, in input order
+    std::vector<TransactionStatus> processTransactionsConcurrently(
+        const std::vector<std::shared_ptr<Transaction>>& transactions);
 
     // Deadlock management
     DeadlockPrevention& getDeadlockManager() { return deadlock_manager; }
+    TransactionJournal& getJournal() { return journal; }
 
     // Admin operations
     bool isAdmin() const;
@@ -120,13 +163,41 @@ private:
     // Helper methods
     void updateSystemStats();
     void logSystemEvent(const std::string& event) const;
-    bool validateTransactionLimits(double amount, AccountType type) const;
+    bool validateTransactionLimits(Money amount, AccountType type) const;
     
     // Cache helper methods
     void addToUserCache(std::shared_ptr<User> user);
     void addToAccountCache(std::shared_ptr<Account> account);
     void removeFromUserCache(int user_id);
     void removeFromAccountCache(int account_id);
+    std::shared_ptr<Account> cacheAccount(std::shared_ptr<Account> account);
+    bool lookupAccountOwner(int account_id, int& owner_id) const;
+    void recordAccountOwner(int account_id, int owner_id);
+    std::shared_ptr<Account> loadAccount(int account_id);
+    void applySyncedBalance(Account& account);
+    void writeSyncFile(const Account& account);
+    void markBalanceDirty(std::shared_ptr<Account> account);
+    void flushDirtyBalances();
+    void balanceWriterLoop();
+
+    // Journal helpers
+    bool recoverFromJournal();
+    void importLegacyTransactions();
+    void checkpointBalances();
+    bool journalTransaction(const Transaction& transaction); // False if the record is not durable
+    void rollBackUndurable(const std::shared_ptr<Transaction>& transaction);
+
+    // Transfer helpers
+    TransactionStatus transferOptimistic(const std::shared_ptr<Account>& from_account,
+                                         const std::shared_ptr<Account>& to_account, Money amount);
+
+    // Batch execution helpers
+    WorkStealingScheduler& getTransactionScheduler();
+    TransactionStatus executeBatchTransaction(const std::shared_ptr<Transaction>& batch_transaction, uint64_t& lsn);
+
+    // Interest helpers
+    bool postInterestChunk(const InterestSnapshot& snapshot, size_t begin, size_t end,
+                           const std::string& period, size_t& posted, Money& chunk_interest);
 };
 
 #endif // BANK_SYSTEM_H
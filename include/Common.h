@@ -1,6 +1,8 @@
 #ifndef COMMON_H
 #define COMMON_H
 
+#include "Money.h"
+
 // Common enums and types used across the banking system
 
 enum class TransactionStatus {
@@ -23,12 +25,21 @@ enum class TransactionType {
 
 // Common constants
 namespace BankingConstants {
-    const double MAX_TRANSACTION_AMOUNT = 1000000.0;
-    const double MIN_TRANSACTION_AMOUNT = 0.01;
+    const Money MAX_TRANSACTION_AMOUNT = Money::fromMajorUnits(1000000);
+    const Money MIN_TRANSACTION_AMOUNT = Money::fromMinorUnits(1);
     const double DEFAULT_SAVINGS_INTEREST_RATE = 0.035; // 3.5%
     const int MAX_LOGIN_ATTEMPTS = 5;
     const int RATE_LIMIT_WINDOW_MINUTES = 15;
     const int SESSION_TIMEOUT_HOURS = 24;
+    const int JOURNAL_GROUP_COMMIT_MICROS = 200; // How long the journal waits to batch fsyncs
+    const int DB_READER_POOL_SIZE = 8; // Read-only SQLite connections shared by lookups
+    const int DB_WRITE_BATCH_LIMIT = 512; // Most writes the database writer commits at once
+    const int DB_WRITE_BATCH_MICROS = 0; // Extra wait to fill a database batch (0: take what queued during the last commit)
+    const int ID_BLOCK_SIZE = 100; // Ids leased from the database at a time, per sequence
+    const int MONTHLY_INTEREST_DAYS = 30; // Days of interest one monthly posting covers
+    const int INTEREST_CHUNK_SIZE = 4096; // Accounts per interest computation and database commit
+    const int LOCK_TABLE_STRIPES = 64; // Independently locked partitions of the account lock table
+    const int OPTIMISTIC_TRANSFER_RETRIES = 16; // Validation failures an optimistic transfer retries before giving up
 }
 
 #endif // COMMON_H
@@ -5,18 +5,79 @@
 #include <vector>
 #include <memory>
 #include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <future>
+#include <deque>
+#include <utility>
+#include <atomic>
+#include <cstdint>
 #include "User.h"
 #include "Account.h"
 #include "Transaction.h"
+#include "IdAllocator.h"
 
 #ifdef USE_MYSQL
 #include <mysqlx/xdevapi.h>
 #endif
 
+// One page of an account's history, newest first. Pass next_cursor back to get
+// the following (older) page; it is empty once the history is exhausted.
+struct TransactionPage {
+    std::vector<std::shared_ptr<Transaction>> transactions;
+    std::string next_cursor;
+};
+
 #ifdef USE_SQLITE
 #include <sqlite3.h>
 #endif
 
+// Statements kept prepared for the life of the connection, one slot each
+enum class StatementId {
+    INSERT_USER,
+    GET_USER_BY_EMAIL,
+    INSERT_ACCOUNT,
+    RESERVE_ID_BLOCK,
+    UPDATE_INTEREST_RUN,
+    UPDATE_ACCOUNT,
+    DELETE_ACCOUNT,
+    GET_ACCOUNT_BY_ID,
+    GET_ACCOUNTS_BY_USER_ID,
+    GET_ALL_USERS,
+    GET_ALL_ACCOUNTS,
+    INSERT_TRANSACTION,
+    UPDATE_TRANSACTION,
+    ACCOUNT_HISTORY,
+    HISTORY_FIRST_PAGE,
+    HISTORY_NEXT_PAGE,
+    COUNT
+};
+
+// An account update or transaction insert waiting for the database writer thread
+struct PendingWrite {
+    enum class Kind { UPDATE_ACCOUNT, INSERT_TRANSACTION };
+
+    Kind kind;
+    int account_id = 0;      // UPDATE_ACCOUNT
+    int transaction_id = 0;  // INSERT_TRANSACTION; 0 lets the database pick
+    Money balance;           // UPDATE_ACCOUNT
+    int from_account_id = 0; // INSERT_TRANSACTION; 0 is stored as NULL
+    int to_account_id = 0;
+    Money amount;
+    std::string type;
+    std::string status;
+    std::string description;
+    std::promise<bool> done; // Set once the batch holding this write commits or fails
+};
+
+#ifdef USE_SQLITE
+// A read-only connection and the statements prepared on it
+struct ReaderConnection {
+    sqlite3* handle = nullptr;
+    sqlite3_stmt* statements[static_cast<size_t>(StatementId::COUNT)] = {};
+};
+#endif
+
 class DatabaseHandler {
 private:
     static std::unique_ptr<DatabaseHandler> instance;
@@ -30,10 +91,36 @@ private:
 #ifdef USE_SQLITE
     sqlite3* db;
     std::string db_path;
+    // Prepared on first use, reset after each use, finalized on disconnect
+    sqlite3_stmt* statement_cache[static_cast<size_t>(StatementId::COUNT)];
+
+    // Lookups borrow a reader (WAL lets them run alongside the writer); all writes use db
+    std::vector<std::unique_ptr<ReaderConnection>> idle_readers;
+    size_t open_readers;
+    std::mutex reader_mutex;
+    std::condition_variable reader_cv;
 #endif
 
     mutable std::mutex db_mutex;
     bool connected;
+    std::atomic<uint64_t> statement_cache_hits;
+    std::atomic<uint64_t> statement_cache_misses;
+
+    // Writer thread: queued account updates and transaction inserts are committed
+    // together, one BEGIN IMMEDIATE ... COMMIT per batch
+    std::deque<PendingWrite> write_queue;
+    std::mutex write_queue_mutex;
+    std::condition_variable write_queue_cv;
+    std::thread writer_thread;
+    bool writer_running;
+    bool writer_stopping;
+    std::atomic<uint64_t> write_batches_committed;
+    std::atomic<uint64_t> writes_committed;
+
+    // Ids come from leased blocks, not a MAX() query per insert
+    IdAllocator user_ids;
+    IdAllocator account_ids;
+    IdAllocator transaction_ids;
 
     // Private constructor for singleton
     DatabaseHandler();
@@ -57,6 +144,8 @@ public:
     // Database initialization
     bool initializeDatabase();
     bool createTables();
+    bool migrateSchema();
+    int getSchemaVersion();
     bool dropTables();
 
     // User operations
@@ -71,18 +160,30 @@ public:
     bool insertAccount(const Account& account);
     std::shared_ptr<Account> getAccountById(int account_id);
     std::vector<std::shared_ptr<Account>> getAccountsByUserId(int user_id);
-    bool updateAccount(const Account& account);
+    bool updateAccount(const Account& account); // Waits for the writer to commit it
+    std::future<bool> updateAccountAsync(const Account& account);
+    bool updateAccountBalances(const std::vector<std::pair<int, Money>>& balances); // One transaction for all
     bool deleteAccount(int account_id);
     std::vector<std::shared_ptr<Account>> getAllAccounts();
 
     // Transaction operations
-    bool insertTransaction(const Transaction& transaction);
+    bool insertTransaction(const Transaction& transaction); // Waits for the writer to commit it
+    std::future<bool> insertTransactionAsync(const Transaction& transaction);
+    bool insertTransactions(const std::vector<std::shared_ptr<Transaction>>& transactions); // One transaction for all
     std::shared_ptr<Transaction> getTransactionById(int transaction_id);
     std::vector<std::shared_ptr<Transaction>> getTransactionsByAccountId(int account_id);
+    TransactionPage getTransactionsByAccountId(int account_id, int limit, const std::string& cursor = "");
     std::vector<std::shared_ptr<Transaction>> getTransactionsByUserId(int user_id);
     bool updateTransaction(const Transaction& transaction);
     std::vector<std::shared_ptr<Transaction>> getAllTransactions();
 
+    // Interest runs (one per period, e.g. "2026-10")
+    bool startInterestRun(const std::string& period, double annual_rate, double& run_rate, bool& completed,
+                          bool& resumed);
+    bool postInterestChunk(const std::string& period, const std::vector<std::shared_ptr<Transaction>>& transactions,
+                           const std::vector<std::pair<int, Money>>& balances);
+    bool finishInterestRun(const std::string& period);
+
     // Transaction management (ACID compliance)
     bool beginTransaction();
     bool commitTransaction();
@@ -92,19 +193,58 @@ public:
     int getNextUserId();
     int getNextAccountId();
     int getNextTransactionId();
+    bool reserveTransactionIds(int count, int& first_id); // count consecutive ids in one reservation
     
     // Database maintenance
     bool vacuum();
     bool backup(const std::string& backup_path);
     bool restore(const std::string& backup_path);
 
+    // Prepared statement cache statistics
+    uint64_t getStatementCacheHits() const { return statement_cache_hits; }
+    uint64_t getStatementCacheMisses() const { return statement_cache_misses; }
+
+    // Writer thread statistics
+    uint64_t getWriteBatchCount() const { return write_batches_committed; }
+    uint64_t getBatchedWriteCount() const { return writes_committed; }
+
 private:
     // Helper methods
     bool executeQuery(const std::string& query);
     std::string escapeString(const std::string& input);
+
+    // Writer thread
+    void startWriter();
+    void stopWriter();
+    std::future<bool> enqueueWrite(PendingWrite write);
+    void writerLoop();
+    void commitWriteBatch(std::vector<PendingWrite>& batch);
+
+    // Id leasing
+    IdAllocator::BlockReserver reserveIdBlockFn();
+    bool reserveIdBlock(const std::string& sequence, int block_size, int& first_id);
     
 #ifdef USE_SQLITE
     bool prepareSQLiteStatement(const std::string& query, sqlite3_stmt** stmt);
+    // Cached statement for id, preparing sql on first use (caller holds db_mutex)
+    sqlite3_stmt* prepareCached(StatementId id, const char* sql);
+    sqlite3_stmt* prepareCached(ReaderConnection& reader, StatementId id, const char* sql);
+    sqlite3_stmt* prepareInto(sqlite3* handle, sqlite3_stmt*& slot, const char* sql);
+    void finalizeCachedStatements();
+
+    // Reader pool: acquire blocks while every reader is busy and the pool is full
+    class ReaderLease;
+    std::unique_ptr<ReaderConnection> acquireReader();
+    void releaseReader(std::unique_ptr<ReaderConnection> reader);
+    void closeReaders();
+    int executeWrite(const PendingWrite& write); // Returns the sqlite3_step result
+    int stepAccountUpdate(int account_id, Money balance);
+    int stepTransactionInsert(int transaction_id, int from_account_id, int to_account_id, Money amount,
+                              const std::string& type, const std::string& status, const std::string& description);
+    bool beginBulkWrite();
+    bool commitBulkWrite();
+    bool stepTransactionInserts(const std::vector<std::shared_ptr<Transaction>>& transactions);
+    bool stepAccountUpdates(const std::vector<std::pair<int, Money>>& balances);
 #endif
 };
 
@@ -8,101 +8,238 @@
 #include <thread>
 #include <chrono>
 #include <condition_variable>
+#include <memory>
+#include <atomic>
+#include <deque>
+#include <cstdint>
+#include "Common.h"
 
 enum class DeadlockStrategy {
     LOCK_ORDERING,      // Always lock accounts in ascending order of account_id
     WAIT_DIE,          // Older transaction waits, younger dies
     WOUND_WAIT,        // Older transaction wounds younger, younger waits
-    TIMEOUT_ROLLBACK   // Rollback if waiting too long
+    TIMEOUT_ROLLBACK,  // Rollback if waiting too long
+    OPTIMISTIC         // Transfers take no locks here: they validate account versions and retry
+};
+
+// Identity of one transaction in the lock manager, from beginTransaction to
+// endTransaction. Age comes from the start time, so it stays correct when a
+// pooled thread runs many transactions.
+struct TransactionHandle {
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+    uint32_t slot = NO_SLOT;  // Index into the transaction slab
+    uint32_t generation = 0;  // Tells this transaction from later users of the slot
+    int transaction_id = 0;
+    std::chrono::steady_clock::time_point start;
+
+    bool isValid() const { return slot != NO_SLOT; }
+    bool isOlderThan(const TransactionHandle& other) const {
+        return start != other.start ? start < other.start : transaction_id < other.transaction_id;
+    }
+    bool operator==(const TransactionHandle& other) const {
+        return slot == other.slot && generation == other.generation;
+    }
+    bool operator!=(const TransactionHandle& other) const { return !(*this == other); }
+};
+
+// A request parked on one account's wait queue. It lives on the waiting
+// thread's stack; whoever grants or aborts it sets the flag under its mutex.
+struct LockWaiter {
+    TransactionHandle owner;
+    DeadlockStrategy policy; // Re-applied whenever the account changes hands
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool granted = false; // The releasing thread handed the account over
+    bool aborted = false; // Wounded, or died when a younger transaction got the account first
+
+    LockWaiter(const TransactionHandle& owner, DeadlockStrategy policy) : owner(owner), policy(policy) {}
 };
 
 struct LockRequest {
-    size_t thread_hash;
+    TransactionHandle requester;
     int account_id;
     std::chrono::steady_clock::time_point request_time;
-    int transaction_id;
+    TransactionHandle blocked_by; // Holder of account_id when the request started waiting
+    LockWaiter* waiter;           // Set while the request is parked
 
-    LockRequest(size_t t_hash, int acc_id, int txn_id)
-        : thread_hash(t_hash), account_id(acc_id),
-          request_time(std::chrono::steady_clock::now()), transaction_id(txn_id) {}
+    LockRequest() : account_id(0), waiter(nullptr) {}
+    LockRequest(const TransactionHandle& txn, int acc_id, const TransactionHandle& holder, LockWaiter* parked)
+        : requester(txn), account_id(acc_id), request_time(std::chrono::steady_clock::now()),
+          blocked_by(holder), waiter(parked) {}
+};
+
+// Current holder of one account and the requests queued behind it
+struct AccountLock {
+    TransactionHandle owner;
+    std::deque<LockWaiter*> waiters; // FIFO: release hands the account to the front
 };
 
 class DeadlockPrevention {
 private:
+    // One partition of the lock table. Padded so stripes used by different
+    // threads do not share a cache line.
+    struct alignas(64) LockStripe {
+        std::mutex mutex;
+        std::unordered_map<int, AccountLock> locks; // Held accounts only
+    };
+
+    // Per-transaction state, recycled through a lock-free free list
+    struct TransactionSlot {
+        std::atomic<uint64_t> state{0};          // generation << 1 | wounded
+        std::atomic<uint32_t> next_free{0};      // Free list link (slot index + 1, 0 ends the list)
+        // Wait-for edge, guarded by wait_graph_mutex. request.blocked_by is always
+        // the current holder of request.account_id: hand-offs re-point it.
+        bool waiting = false;                    // request is valid
+        LockRequest request;                     // What it is parked on
+        std::chrono::steady_clock::time_point edge_since; // When blocked_by last changed
+        size_t waiting_index = 0;                // Position in waiting_slots
+        uint64_t walk_stamp = 0;                 // Last cycle search that reached it
+    };
+    static constexpr uint32_t SLAB_CHUNK_SIZE = 256;
+    static constexpr uint32_t SLAB_MAX_CHUNKS = 4096;
+
+    // What a request does when the account it wants is held
+    enum class ConflictAction { WAIT, DIE, WOUND };
+    enum class AcquireResult { GRANTED, DIED, ABORTED, TIMED_OUT };
+
     DeadlockStrategy strategy;
-    std::mutex wait_graph_mutex;
-    std::unordered_map<size_t, std::unordered_set<int>> thread_locks;
-    std::unordered_map<size_t, std::vector<LockRequest>> waiting_requests;
-    std::unordered_map<int, size_t> account_owners;
-    std::unordered_map<size_t, int> thread_timestamps;
-    
+
+    // Account ids hash into stripes. Accounts are acquired one at a time with
+    // only that account's stripe locked, so unrelated requests never contend.
+    std::unique_ptr<LockStripe[]> stripes;
+    size_t stripe_count;
+
+    // Transaction slab: fixed-size chunks so slots never move, found by index
+    std::unique_ptr<std::atomic<TransactionSlot*>[]> slab_chunks;
+    std::atomic<uint32_t> slab_chunk_count;
+    std::atomic<uint64_t> free_head; // ABA tag << 32 | (slot index + 1)
+    std::mutex slab_grow_mutex;
+
+    // Wait-for graph, only touched when a request has to wait. Every waiting
+    // transaction has one edge, to the holder of the account it wants.
+    // Lock order: stripe, then wait_graph_mutex, then a LockWaiter's mutex.
+    mutable std::mutex wait_graph_mutex;
+    std::vector<uint32_t> waiting_slots;
+    mutable uint64_t walk_stamp;
+
+    // Background detector
+    std::thread detector_thread;
+    mutable std::mutex detector_mutex;
+    std::condition_variable detector_cv;
+    bool detector_stopping;
+
     // Timeout settings
     std::chrono::milliseconds lock_timeout;
     std::chrono::milliseconds deadlock_check_interval;
-    
+
     // Statistics
-    int deadlocks_detected;
-    int deadlocks_prevented;
-    int transactions_aborted;
+    std::atomic<int> deadlocks_detected;
+    std::atomic<int> deadlocks_prevented;
+    std::atomic<int> transactions_aborted;
+    std::atomic<uint64_t> lock_waits;
+    std::atomic<uint64_t> lock_wait_micros;
+    std::atomic<uint64_t> deadlock_victims;
+    std::atomic<uint64_t> detection_latency_micros; // Cycle closed until victim chosen, summed
+    std::atomic<uint64_t> max_detection_latency_micros;
+    std::atomic<uint64_t> optimistic_commits;
+    std::atomic<uint64_t> optimistic_conflicts; // Failed validations, each one retried or aborted
 
 public:
     // Constructor
     explicit DeadlockPrevention(DeadlockStrategy strategy = DeadlockStrategy::LOCK_ORDERING);
-    
+
     // Destructor
     ~DeadlockPrevention();
 
+    // Delete copy constructor and assignment operator
+    DeadlockPrevention(const DeadlockPrevention&) = delete;
+    DeadlockPrevention& operator=(const DeadlockPrevention&) = delete;
+
+    // Transaction lifecycle (release the locks before ending)
+    TransactionHandle beginTransaction(int transaction_id);
+    void endTransaction(TransactionHandle& transaction);
+
     // Lock management with deadlock prevention
+    bool requestLocks(const TransactionHandle& transaction, const std::vector<int>& account_ids);
+    void releaseLocks(const TransactionHandle& transaction, const std::vector<int>& account_ids);
+    void releaseAllLocks(const TransactionHandle& transaction);
+
+    // Same, on an implicit transaction of the calling thread that releaseLocks ends
     bool requestLocks(const std::vector<int>& account_ids, int transaction_id);
     void releaseLocks(const std::vector<int>& account_ids);
-    void releaseAllLocks();
-    
+
     // Deadlock detection and resolution
     bool detectDeadlock();
-    bool resolveDeadlock();
-    std::vector<size_t> findDeadlockCycle();
-    
+    bool resolveDeadlock(); // Aborts the youngest transaction of every cycle
+    std::vector<TransactionHandle> findDeadlockCycle();
+
+    // Background detector: resolveDeadlock every deadlock_check_interval until stopped.
+    // Only TIMEOUT_ROLLBACK can form cycles; without the detector they last until lock_timeout.
+    bool startDetector(); // False if it is already running
+    void stopDetector();
+    bool isDetectorRunning() const;
+    void setCheckInterval(std::chrono::milliseconds interval);
+
     // Strategy-specific methods
-    bool lockOrderingStrategy(const std::vector<int>& account_ids, int transaction_id);
-    bool waitDieStrategy(const std::vector<int>& account_ids, int transaction_id);
-    bool woundWaitStrategy(const std::vector<int>& account_ids, int transaction_id);
-    bool timeoutRollbackStrategy(const std::vector<int>& account_ids, int transaction_id);
-    
+    bool lockOrderingStrategy(const TransactionHandle& transaction, const std::vector<int>& account_ids);
+    bool waitDieStrategy(const TransactionHandle& transaction, const std::vector<int>& account_ids);
+    bool woundWaitStrategy(const TransactionHandle& transaction, const std::vector<int>& account_ids);
+    bool timeoutRollbackStrategy(const TransactionHandle& transaction, const std::vector<int>& account_ids);
+
     // Utility methods
     void setStrategy(DeadlockStrategy new_strategy);
     DeadlockStrategy getStrategy() const;
     void setTimeout(std::chrono::milliseconds timeout);
-    
+
     // Statistics and monitoring
     int getDeadlocksDetected() const;
     int getDeadlocksPrevented() const;
     int getTransactionsAborted() const;
+    uint64_t getLockWaits() const { return lock_waits; }
+    uint64_t getLockWaitMicros() const { return lock_wait_micros; }
+    uint64_t getDeadlockVictims() const { return deadlock_victims; }
+    uint64_t getDetectionLatencyMicros() const { return detection_latency_micros; }
+    uint64_t getMaxDetectionLatencyMicros() const { return max_detection_latency_micros; }
+    uint64_t getOptimisticCommits() const { return optimistic_commits; }
+    uint64_t getOptimisticConflicts() const { return optimistic_conflicts; }
+    void recordOptimisticConflict() { optimistic_conflicts++; }
+    void recordOptimisticOutcome(bool committed); // Aborted if it ran out of retries
     void resetStatistics();
     void displayStatistics() const;
-    
-    // Thread management
-    void registerThread(int transaction_id);
-    void unregisterThread();
-    int getThreadTimestamp(size_t thread_hash) const;
 
     // Wait graph analysis
     bool hasCycle() const;
-    std::vector<size_t> getWaitingThreads() const;
+    std::vector<TransactionHandle> getWaitingTransactions() const;
     std::vector<int> getLockedAccounts() const;
 
 private:
     // Helper methods
-    bool tryLockAccounts(const std::vector<int>& account_ids);
-    void addToWaitGraph(size_t waiter, const std::vector<int>& account_ids);
-    void removeFromWaitGraph(size_t thread_hash);
-    bool isOlderTransaction(size_t t1, size_t t2) const;
-    void abortTransaction(size_t thread_hash);
-    size_t getThreadHash() const;
-
-    // Cycle detection using DFS
-    bool dfsHasCycle(size_t current,
-                     std::unordered_set<size_t>& visited,
-                     std::unordered_set<size_t>& recursion_stack) const;
+    LockStripe& stripeFor(int account_id) const;
+    size_t stripeIndex(int account_id) const;
+    TransactionSlot& slotAt(uint32_t slot) const;
+    bool isCurrent(const TransactionHandle& transaction) const;
+    bool isWounded(const TransactionHandle& transaction) const;
+    bool acquireAll(const TransactionHandle& transaction, const std::vector<int>& account_ids,
+                    DeadlockStrategy policy);
+    AcquireResult acquireAccount(const TransactionHandle& transaction, int account_id, DeadlockStrategy policy,
+                                 std::chrono::steady_clock::time_point deadline);
+    void releaseAccount(const TransactionHandle& transaction, int account_id);
+    bool handOff(AccountLock& lock); // Caller holds the stripe; false if nobody was waiting
+
+    // Wait-for graph upkeep (caller holds the stripe of account_id)
+    void addToWaitGraph(const TransactionHandle& waiter, int account_id, const TransactionHandle& holder,
+                        LockWaiter* parked);
+    void removeFromWaitGraph(const TransactionHandle& waiter);
+    void abortTransaction(const TransactionHandle& transaction); // Caller holds no stripe and not wait_graph_mutex
+
+    // Caller holds wait_graph_mutex
+    void eraseWaitEdge(uint32_t slot);
+    bool woundTransaction(const TransactionHandle& transaction); // False if already wounded or finished
+    bool nextWaiter(uint32_t slot, uint32_t& next) const;
+    std::vector<std::vector<uint32_t>> findCycles(bool first_only) const;
+
+    void detectorLoop();
 };
 
 #endif // DEADLOCK_PREVENTION_H
@@ -0,0 +1,46 @@
+#ifndef ID_ALLOCATOR_H
+#define ID_ALLOCATOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+// Hands out unique ids for one sequence from an in-memory counter.
+// Ids are leased from persistent storage in blocks; only taking a new block
+// touches storage, so almost every allocation is a single atomic add.
+// Ids left over in a block when the process exits are skipped, never reused.
+class IdAllocator {
+public:
+    // Reserve block_size ids; sets first_id to the first id of the block
+    using BlockReserver = std::function<bool(const std::string& sequence, int block_size, int& first_id)>;
+
+private:
+    std::string sequence;
+    int block_size;
+    BlockReserver reserve_block;
+
+    // Current lease packed as (end << 32) | next, so one fetch_add both takes
+    // an id and tells whether it still falls inside the lease
+    std::atomic<uint64_t> lease;
+    std::mutex refill_mutex;
+    std::atomic<uint64_t> blocks_reserved;
+
+public:
+    IdAllocator(const std::string& sequence, int block_size, BlockReserver reserve_block);
+
+    // Delete copy constructor and assignment operator
+    IdAllocator(const IdAllocator&) = delete;
+    IdAllocator& operator=(const IdAllocator&) = delete;
+
+    // Next unique id, or -1 if a new block could not be reserved
+    int next();
+    // Drop the current lease (e.g. when switching databases)
+    void reset();
+
+    const std::string& getSequence() const { return sequence; }
+    uint64_t getBlocksReserved() const { return blocks_reserved; }
+};
+
+#endif // ID_ALLOCATOR_H
@@ -0,0 +1,40 @@
+#ifndef INTEREST_ENGINE_H
+#define INTEREST_ENGINE_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "Account.h"
+
+// Columnar snapshot of the savings accounts one interest run covers.
+// Balances and results sit in their own contiguous arrays so the interest
+// kernel streams through plain integers instead of chasing Account pointers.
+struct InterestSnapshot {
+    std::vector<int> account_ids;
+    std::vector<int64_t> balances; // Minor units at snapshot time
+    std::vector<int64_t> interest; // Minor units, filled in by computeInterest
+    std::vector<std::shared_ptr<Account>> accounts;
+
+    void add(const std::shared_ptr<Account>& account);
+    size_t size() const { return account_ids.size(); }
+};
+
+namespace InterestEngine {
+    // Annual rate in parts per million, as Account::calculateInterest rounds it
+    int64_t rateToPpm(double annual_rate);
+
+    // interest[i] = balances[i] * rate_ppm * days / (10^6 * 365), rounded half up.
+    // Matches Account::calculateInterest exactly for non-negative balances, using
+    // only 64-bit integer arithmetic in a branch-free loop the compiler can unroll.
+    void computeInterest(const int64_t* balances, int64_t* interest, size_t count, int64_t rate_ppm, int days);
+
+    // Month an interest run belongs to, e.g. "2026-10"; runs are idempotent per period
+    std::string currentPeriod();
+
+    // Description stored on the INTEREST transactions of a period
+    std::string describePeriod(const std::string& period);
+}
+
+#endif // INTEREST_ENGINE_H
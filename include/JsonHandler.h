@@ -42,12 +42,14 @@ private:
     static std::string extractJsonValue(const std::string& json, const std::string& key);
     static bool extractJsonBool(const std::string& json, const std::string& key);
     static double extractJsonDouble(const std::string& json, const std::string& key);
+    static Money extractJsonMoney(const std::string& json, const std::string& key);
     static int extractJsonInt(const std::string& json, const std::string& key);
     
     // JSON creation helpers
     static std::string createJsonString(const std::string& key, const std::string& value);
     static std::string createJsonBool(const std::string& key, bool value);
     static std::string createJsonDouble(const std::string& key, double value);
+    static std::string createJsonMoney(const std::string& key, Money value);
     static std::string createJsonInt(const std::string& key, int value);
     
     // Escape JSON strings
@@ -4,6 +4,9 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <cstddef>
+#include <cstdint>
+#include "Money.h"
 
 // Message types for ATM-Bank communication
 enum class MessageType {
@@ -41,20 +44,20 @@ struct BalanceRequest {
 struct BalanceResponse {
     bool success;
     std::string message;
-    double balance;
+    Money balance;
     std::string account_type;
 };
 
 struct WithdrawRequest {
     std::string session_token;
     int account_id;
-    double amount;
+    Money amount;
 };
 
 struct WithdrawResponse {
     bool success;
     std::string message;
-    double new_balance;
+    Money new_balance;
     std::string transaction_id;
 };
 
@@ -85,11 +88,40 @@ struct NetworkMessage {
 // Protocol constants
 const int DEFAULT_BANK_PORT = 8080;
 const int MAX_MESSAGE_SIZE = 4096;
-const std::string PROTOCOL_VERSION = "1.0";
+const std::string PROTOCOL_VERSION = "1.2";
+
+// Wire framing: each message is a 4-byte big-endian payload length and a
+// 4-byte big-endian request id, followed by the payload itself.
+// Responses echo the id of the request they answer, so a client may keep
+// several requests in flight and match replies arriving out of order.
+// Request id 0 marks a client that does not pipeline.
+const size_t FRAME_HEADER_SIZE = 8;
+const size_t MAX_FRAME_SIZE = 1024 * 1024;
+const size_t RECV_BUFFER_SIZE = 16384;
+
+// Reassembles length-prefixed frames from a TCP byte stream.
+// A single append() may complete several frames or only part of one.
+class FrameDecoder {
+private:
+    std::string buffer;
+    size_t read_offset;
+    bool corrupted;
+
+public:
+    FrameDecoder();
+
+    void append(const char* data, size_t length);
+    bool nextFrame(std::string& payload, uint32_t& request_id);
+
+    bool isCorrupted() const { return corrupted; }
+    size_t bufferedBytes() const { return buffer.size() - read_offset; }
+    void reset();
+};
 
 // Utility functions
 std::string messageTypeToString(MessageType type);
 MessageType stringToMessageType(const std::string& str);
 std::string getCurrentTimestamp();
+std::string encodeFrame(const std::string& payload, uint32_t request_id = 0);
 
 #endif // NETWORK_PROTOCOL_H
@@ -6,6 +6,7 @@
 #include <unordered_map>
 #include <chrono>
 #include <mutex>
+#include "Common.h"
 
 class Security {
 public:
@@ -18,7 +19,7 @@ public:
     static bool isValidEmail(const std::string& email);
     static bool isValidPassword(const std::string& password);
     static bool isValidName(const std::string& name);
-    static bool isValidAmount(double amount);
+    static bool isValidAmount(Money amount);
     static std::string sanitizeInput(const std::string& input);
     
     // SQL injection prevention
@@ -0,0 +1,115 @@
+#ifndef SESSION_STORE_H
+#define SESSION_STORE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "Common.h"
+
+// Everything the server needs to know about a logged-in ATM session
+struct SessionInfo {
+    int user_id;
+    std::string atm_id;
+    std::chrono::steady_clock::time_point expires_at;
+};
+
+// Hierarchical timing wheel of session tokens keyed by expiry tick.
+// Each level has 64 slots; level N slots span 64^N ticks, so three levels of
+// one-second ticks cover about three days. Entries move down a level when the
+// wheel reaches their slot, so scheduling and expiring are O(1) per entry.
+// Not thread-safe; SessionStore serialises access.
+class TimingWheel {
+public:
+    static const size_t LEVELS = 3;
+    static const size_t SLOT_BITS = 6;
+    static const size_t SLOTS_PER_LEVEL = 1 << SLOT_BITS;
+
+    TimingWheel();
+
+    void schedule(const std::string& key, uint64_t expiry_tick);
+    // Move the wheel forward to now_tick and collect every key that fell due
+    void advance(uint64_t now_tick, std::vector<std::string>& expired_keys);
+
+    uint64_t getCurrentTick() const { return current_tick; }
+    size_t getScheduledCount() const { return scheduled_count; }
+
+private:
+    struct Entry {
+        std::string key;
+        uint64_t expiry_tick;
+    };
+
+    std::vector<Entry> slots[LEVELS][SLOTS_PER_LEVEL];
+    std::vector<Entry> overflow; // Beyond the top level; re-placed when it rolls over
+    uint64_t current_tick;
+    size_t scheduled_count;
+
+    void place(Entry entry, std::vector<std::string>& expired_keys);
+    void cascade(std::vector<Entry>& bucket, std::vector<std::string>& expired_keys);
+};
+
+// Session table split into independently locked shards so that lookups for
+// different tokens rarely contend. A background reaper drives the timing wheel
+// once per second and drops sessions older than SESSION_TIMEOUT_HOURS.
+class SessionStore {
+private:
+    // Padded to a cache line so neighbouring shard locks do not false-share
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::unordered_map<std::string, SessionInfo> sessions; // token -> session
+    };
+
+    std::unique_ptr<Shard[]> shards;
+    size_t shard_count;
+    std::chrono::seconds session_ttl;
+
+    // Expiry tracking
+    TimingWheel wheel;
+    std::mutex wheel_mutex;
+    std::chrono::steady_clock::time_point epoch; // Tick 0 of the wheel
+
+    // Reaper thread
+    std::thread reaper;
+    std::mutex reaper_mutex;
+    std::condition_variable reaper_cv;
+    bool stopping;
+
+    // Statistics
+    std::atomic<size_t> sessions_expired;
+
+public:
+    explicit SessionStore(std::chrono::seconds session_ttl =
+                              std::chrono::hours(BankingConstants::SESSION_TIMEOUT_HOURS),
+                          size_t shard_count = 64);
+    ~SessionStore();
+
+    // Delete copy constructor and assignment operator
+    SessionStore(const SessionStore&) = delete;
+    SessionStore& operator=(const SessionStore&) = delete;
+
+    // Session operations
+    void insert(const std::string& token, int user_id, const std::string& atm_id);
+    bool lookup(const std::string& token, SessionInfo& info); // False if missing or expired
+    bool remove(const std::string& token);
+
+    // Monitoring
+    size_t size();
+    size_t getExpiredCount() const { return sessions_expired; }
+
+    // Expire everything that is due now (also run by the reaper every second)
+    void reapExpired();
+
+private:
+    Shard& shardFor(const std::string& token);
+    uint64_t tickFor(std::chrono::steady_clock::time_point time) const;
+    void reaperLoop();
+};
+
+#endif // SESSION_STORE_H
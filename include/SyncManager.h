@@ -24,8 +24,8 @@ public:
     static SyncManager& getInstance();
     
     // Account synchronization
-    bool syncAccountBalance(int account_id, double balance);
-    double getAccountBalance(int account_id);
+    bool syncAccountBalance(int account_id, Money balance);
+    Money getAccountBalance(int account_id);
     bool accountExists(int account_id);
     
     // Transaction synchronization
@@ -33,8 +33,8 @@ public:
     std::vector<std::shared_ptr<Transaction>> getAccountTransactions(int account_id);
     
     // File operations
-    bool loadAccountBalances(std::unordered_map<int, double>& balances);
-    bool saveAccountBalances(const std::unordered_map<int, double>& balances);
+    bool loadAccountBalances(std::unordered_map<int, Money>& balances);
+    bool saveAccountBalances(const std::unordered_map<int, Money>& balances);
     
     bool loadTransactions(std::vector<std::shared_ptr<Transaction>>& transactions);
     bool saveTransaction(const Transaction& transaction);
@@ -0,0 +1,54 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+
+// Fixed-size worker pool with a bounded task queue.
+// submit() blocks while the queue is full, which pushes back on producers
+// instead of growing memory without limit. Threads that must not block (e.g.
+// the server I/O threads) use trySubmit() and keep the task when it refuses.
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    size_t max_queue_size;
+
+    std::mutex queue_mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    bool stopping;
+
+    // Statistics
+    std::atomic<size_t> tasks_completed;
+
+public:
+    explicit ThreadPool(size_t thread_count, size_t max_queue_size = 1024);
+    ~ThreadPool();
+
+    // Delete copy constructor and assignment operator
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Task submission
+    bool submit(std::function<void()> task);
+    bool trySubmit(std::function<void()>& task); // Takes task only when it returns true
+
+    // Lifecycle
+    void shutdown();
+
+    // Monitoring
+    size_t getThreadCount() const { return workers.size(); }
+    size_t getQueuedTaskCount();
+    size_t getTasksCompleted() const { return tasks_completed; }
+
+private:
+    void workerLoop();
+};
+
+#endif // THREAD_POOL_H
@@ -11,7 +11,7 @@ private:
     int transaction_id;
     int from_account_id;
     int to_account_id;
-    double amount;
+    Money amount;
     TransactionType type;
     TransactionStatus status;
     std::string timestamp;
@@ -21,7 +21,7 @@ public:
     // Constructors
     Transaction();
     Transaction(int txn_id, int from_account, int to_account, 
-               double amount, TransactionType type, 
+               Money amount, TransactionType type, 
                TransactionStatus status = TransactionStatus::PENDING);
     
     // Destructor
@@ -31,7 +31,7 @@ public:
     int getTransactionId() const;
     int getFromAccountId() const;
     int getToAccountId() const;
-    double getAmount() const;
+    Money getAmount() const;
     TransactionType getType() const;
     TransactionStatus getStatus() const;
     std::string getTimestamp() const;
@@ -41,10 +41,11 @@ public:
     void setTransactionId(int id);
     void setFromAccountId(int from_id);
     void setToAccountId(int to_id);
-    void setAmount(double amount);
+    void setAmount(Money amount);
     void setType(TransactionType type);
     void setStatus(TransactionStatus status);
     void setDescription(const std::string& desc);
+    void setTimestamp(const std::string& time); // When restoring a recorded transaction
 
     // Transaction operations
     bool execute();
@@ -64,9 +65,9 @@ public:
     std::string toString() const;
 
     // Static factory methods
-    static std::shared_ptr<Transaction> createDeposit(int account_id, double amount);
-    static std::shared_ptr<Transaction> createWithdrawal(int account_id, double amount);
-    static std::shared_ptr<Transaction> createTransfer(int from_account, int to_account, double amount);
+    static std::shared_ptr<Transaction> createDeposit(int account_id, Money amount);
+    static std::shared_ptr<Transaction> createWithdrawal(int account_id, Money amount);
+    static std::shared_ptr<Transaction> createTransfer(int from_account, int to_account, Money amount);
 };
 
 #endif // TRANSACTION_H
@@ -0,0 +1,138 @@
+#ifndef TRANSACTION_JOURNAL_H
+#define TRANSACTION_JOURNAL_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <deque>
+#include <utility>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "Common.h"
+#include "Transaction.h"
+
+// One entry of the transaction journal
+struct JournalRecord {
+    enum class Kind : uint8_t {
+        TRANSACTION = 1, // Committed operation; replayed into balances on recovery
+        CHECKPOINT = 2,  // Full balance of one account; replay restarts from here
+        IMPORTED = 3     // History imported from transactions.sync; never replayed
+    };
+
+    Kind kind;
+    int transaction_id;
+    int from_account_id;
+    int to_account_id; // CHECKPOINT: the account
+    Money amount;      // CHECKPOINT: the account balance
+    TransactionType type;
+    TransactionStatus status;
+    std::string timestamp;
+    std::string description;
+
+    static JournalRecord fromTransaction(const Transaction& transaction, Kind kind = Kind::TRANSACTION);
+    static JournalRecord checkpoint(int account_id, Money balance);
+    std::shared_ptr<Transaction> toTransaction() const;
+    bool involvesAccount(int account_id) const;
+};
+
+// Append-only binary write-ahead journal of committed transactions.
+// Records are framed as [length][CRC32][payload] after an 8-byte file header.
+// Appenders only serialise into a shared buffer; a dedicated writer thread
+// writes everything queued in one write() and one fdatasync() (group commit),
+// so concurrent commits share the cost of a flush. On open, records are read
+// back up to the first torn or corrupt one and the tail is truncated.
+//
+// A per-account index of record offsets lives in <path>.idx as fixed-size
+// (account id, offset) entries. It is appended after every batch and is only a
+// hint: on open it is checked against the journal and extended or rebuilt, and
+// records written by another process are indexed when they are first noticed.
+class TransactionJournal {
+private:
+    std::string path;
+    int fd;
+    std::string index_path;
+    int index_fd;
+    std::chrono::microseconds group_commit_window;
+
+    // Queue shared by appenders and the writer
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;   // Wakes the writer
+    std::condition_variable durable_cv; // Wakes committers
+    std::string pending_bytes;
+    uint64_t last_lsn;    // Sequence number of the newest queued record
+    uint64_t completed_lsn; // Every record up to here is on disk or in failed_batches
+    std::deque<std::pair<uint64_t, uint64_t>> failed_batches; // First and last lsn of batches that were lost
+    bool stopping;
+    bool broken; // A failed batch could not be cut off the file; nothing more is written
+    std::thread writer;
+
+    // Per-account index (account_id -> journal offsets, oldest first)
+    std::unordered_map<int, std::vector<uint64_t>> account_offsets;
+    uint64_t indexed_end; // Every record before this offset is indexed
+    mutable std::shared_mutex index_mutex;
+
+    // Statistics
+    std::atomic<uint64_t> records_appended;
+    std::atomic<uint64_t> syncs_performed;
+
+public:
+    explicit TransactionJournal(const std::string& path = "transactions.journal",
+                                std::chrono::microseconds group_commit_window =
+                                    std::chrono::microseconds(BankingConstants::JOURNAL_GROUP_COMMIT_MICROS));
+    ~TransactionJournal();
+
+    // Delete copy constructor and assignment operator
+    TransactionJournal(const TransactionJournal&) = delete;
+    TransactionJournal& operator=(const TransactionJournal&) = delete;
+
+    // Recover the valid records, truncate any torn tail and start the writer
+    bool open(std::vector<JournalRecord>& recovered);
+    // Flush everything queued and stop the writer
+    void close();
+    bool isOpen() const { return fd >= 0; }
+
+    // Queue a record; returns its sequence number (0 if the journal is closed)
+    uint64_t append(const JournalRecord& record);
+    // Block until the record with this sequence number is on disk
+    bool waitForDurable(uint64_t lsn);
+    // Append and wait: returns once the record is durable
+    bool commit(const JournalRecord& record);
+
+    // Read every record currently in the file
+    bool readAll(std::vector<JournalRecord>& records) const;
+    // Read the records involving one account, seeking straight to each via the index
+    bool readAccountRecords(int account_id, std::vector<JournalRecord>& records);
+    // Read one page of an account's records, newest first (before/next_before: see the .cpp)
+    bool readAccountPage(int account_id, size_t limit, uint64_t before,
+                         std::vector<JournalRecord>& records, uint64_t& next_before);
+
+    void setGroupCommitWindow(std::chrono::microseconds window);
+    uint64_t getAppendedCount() const { return records_appended; }
+    uint64_t getSyncCount() const { return syncs_performed; }
+
+private:
+    void writerLoop();
+    bool writeBatch(const std::string& batch, bool& file_intact); // file_intact: a failure left no bytes behind
+    bool readFile(std::string& contents) const;
+    bool readRecordAt(uint64_t offset, JournalRecord& record) const;
+    // Decode records starting at start; returns the offset just past the last valid one
+    static size_t scanRecords(const std::string& contents, size_t start, std::vector<JournalRecord>& records,
+                              std::vector<size_t>* offsets = nullptr);
+    static void encodeRecord(const JournalRecord& record, std::string& out);
+    static bool decodePayload(const char* data, size_t length, JournalRecord& record);
+
+    // Index maintenance (callers hold index_mutex exclusively)
+    bool openIndex(const std::string& contents, const std::vector<JournalRecord>& records,
+                   const std::vector<size_t>& offsets, size_t valid_end);
+    void indexBytes(const std::string& bytes, uint64_t base);
+    void catchUpIndex(uint64_t end);
+    std::shared_lock<std::shared_mutex> lockCurrentIndex();
+};
+
+#endif // TRANSACTION_JOURNAL_H
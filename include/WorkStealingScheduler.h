@@ -0,0 +1,71 @@
+#ifndef WORK_STEALING_SCHEDULER_H
+#define WORK_STEALING_SCHEDULER_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+
+// Worker pool where every thread owns a task deque.
+// A task submitted from a worker goes onto that worker's own deque and is taken
+// back newest first, so follow-up work runs on the thread that produced it.
+// Tasks from other threads are spread round-robin. An idle worker steals the
+// oldest task from another worker's deque before going to sleep.
+class WorkStealingScheduler {
+public:
+    using Task = std::function<void()>;
+
+private:
+    // Padded so neighbouring workers' deques do not share a cache line
+    struct alignas(64) WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+
+    // Sleeping workers wait here until something is queued
+    std::mutex idle_mutex;
+    std::condition_variable work_cv;
+    std::atomic<size_t> queued_tasks;
+    std::atomic<size_t> sleeping_workers;
+    std::atomic<size_t> next_queue;
+    std::atomic<bool> stopping;
+
+    // Statistics
+    std::atomic<uint64_t> tasks_executed;
+    std::atomic<uint64_t> tasks_stolen;
+
+public:
+    explicit WorkStealingScheduler(size_t thread_count = 0); // 0: one per hardware thread
+    ~WorkStealingScheduler();
+
+    // Delete copy constructor and assignment operator
+    WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+    WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+
+    // Task submission (false once shut down)
+    bool submit(Task task);
+
+    // Lifecycle: run everything already queued, then join the workers
+    void shutdown();
+
+    // Monitoring
+    size_t getThreadCount() const { return workers.size(); }
+    uint64_t getTasksExecuted() const { return tasks_executed; }
+    uint64_t getTasksStolen() const { return tasks_stolen; }
+
+private:
+    void workerLoop(size_t index);
+    bool popLocal(size_t index, Task& task);
+    bool steal(size_t thief, Task& task);
+    void wakeWorker();
+};
+
+#endif // WORK_STEALING_SCHEDULER_H
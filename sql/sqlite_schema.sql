@@ -2,6 +2,8 @@
 -- SQLite-compatible version
 
 -- Drop tables if they exist (for clean setup)
+DROP TABLE IF EXISTS interest_runs;
+DROP TABLE IF EXISTS id_sequences;
 DROP TABLE IF EXISTS Transactions;
 DROP TABLE IF EXISTS Accounts;
 DROP TABLE IF EXISTS Users;
@@ -28,13 +30,13 @@ CREATE INDEX idx_users_active ON Users(is_active);
 CREATE TABLE Accounts (
     account_id INTEGER PRIMARY KEY AUTOINCREMENT,
     user_id INTEGER NOT NULL,
-    balance REAL NOT NULL DEFAULT 0.00,
+    balance INTEGER NOT NULL DEFAULT 0, -- cents
     account_type TEXT NOT NULL DEFAULT 'SAVINGS',
     created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
     updated_at DATETIME DEFAULT CURRENT_TIMESTAMP,
     is_active INTEGER DEFAULT 1,
     interest_rate REAL DEFAULT 0.0350,
-    minimum_balance REAL DEFAULT 0.00,
+    minimum_balance INTEGER DEFAULT 0, -- cents
     FOREIGN KEY (user_id) REFERENCES Users(user_id) ON DELETE CASCADE,
     CHECK (balance >= 0),
     CHECK (interest_rate >= 0 AND interest_rate <= 1),
@@ -45,13 +47,14 @@ CREATE TABLE Accounts (
 CREATE INDEX idx_accounts_user_id ON Accounts(user_id);
 CREATE INDEX idx_accounts_type ON Accounts(account_type);
 CREATE INDEX idx_accounts_active ON Accounts(is_active);
+CREATE INDEX idx_accounts_user_active ON Accounts(user_id, is_active, account_id, balance, account_type);
 
 -- Transactions table
 CREATE TABLE Transactions (
     transaction_id INTEGER PRIMARY KEY AUTOINCREMENT,
     from_account_id INTEGER,
     to_account_id INTEGER,
-    amount REAL NOT NULL,
+    amount INTEGER NOT NULL, -- cents
     transaction_type TEXT NOT NULL,
     status TEXT NOT NULL DEFAULT 'PENDING',
     description TEXT,
@@ -72,6 +75,38 @@ CREATE INDEX idx_transactions_type ON Transactions(transaction_type);
 CREATE INDEX idx_transactions_status ON Transactions(status);
 CREATE INDEX idx_transactions_created_at ON Transactions(created_at);
 CREATE INDEX idx_transactions_reference ON Transactions(reference_number);
+CREATE INDEX idx_transactions_from_history ON Transactions(from_account_id, created_at DESC, transaction_id DESC,
+    to_account_id, amount, transaction_type, status, description);
+CREATE INDEX idx_transactions_to_history ON Transactions(to_account_id, created_at DESC, transaction_id DESC,
+    from_account_id, amount, transaction_type, status, description);
+
+-- Schema versions already reflected in this file (see SCHEMA_MIGRATIONS in DatabaseHandler.cpp)
+CREATE TABLE IF NOT EXISTS schema_migrations (
+    version INTEGER PRIMARY KEY,
+    description TEXT NOT NULL,
+    applied_at DATETIME DEFAULT CURRENT_TIMESTAMP
+);
+INSERT OR IGNORE INTO schema_migrations (version, description) VALUES
+(1, 'Store money columns as INTEGER cents'),
+(2, 'Covering indexes for account and history lookups'),
+(3, 'Leased id sequences for users, accounts and transactions'),
+(4, 'Interest run progress');
+
+-- Id sequences: every id below reserved_through has been leased to a server process
+CREATE TABLE id_sequences (
+    name TEXT PRIMARY KEY,
+    reserved_through INTEGER NOT NULL
+);
+
+-- Monthly interest runs: one row per period, completed_at is set once every account is posted
+CREATE TABLE interest_runs (
+    period TEXT PRIMARY KEY,
+    annual_rate REAL NOT NULL,
+    accounts_posted INTEGER NOT NULL DEFAULT 0,
+    interest_posted INTEGER NOT NULL DEFAULT 0,
+    started_at DATETIME DEFAULT CURRENT_TIMESTAMP,
+    completed_at DATETIME
+);
 
 -- Sessions table (for security)
 CREATE TABLE Sessions (
@@ -118,8 +153,14 @@ INSERT INTO Users (name, email, password_hash, salt) VALUES
 
 -- Insert sample accounts for testing
 INSERT INTO Accounts (user_id, balance, account_type, minimum_balance) VALUES 
-(1, 10000.00, 'SAVINGS', 1000.00),
-(1, 5000.00, 'CURRENT', 0.00);
+(1, 1000000, 'SAVINGS', 100000),
+(1, 500000, 'CURRENT', 0);
+
+-- Start the id sequences after the sample rows
+INSERT INTO id_sequences (name, reserved_through) VALUES
+('users', (SELECT COALESCE(MAX(user_id), 0) + 1 FROM Users)),
+('accounts', (SELECT COALESCE(MAX(account_id), 0) + 1 FROM Accounts)),
+('transactions', (SELECT COALESCE(MAX(transaction_id), 0) + 1 FROM Transactions));
 
 -- Create views for reporting
 CREATE VIEW AccountSummary AS
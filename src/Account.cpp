@@ -5,11 +5,11 @@
 #include <iomanip>
 #include <chrono>
 #include <sstream>
-#include <fstream>
 #include <mutex>
+#include <cmath>
 
 // Default constructor
-Account::Account() : account_id(0), user_id(0), balance(0.0), account_type(AccountType::SAVINGS) {
+Account::Account() : account_id(0), user_id(0), balance_minor(0), version(0), account_type(AccountType::SAVINGS) {
     auto now = std::chrono::system_clock::now();
     auto time_t = std::chrono::system_clock::to_time_t(now);
     std::stringstream ss;
@@ -18,8 +18,9 @@ Account::Account() : account_id(0), user_id(0), balance(0.0), account_type(Accou
 }
 
 // Parameterized constructor
-Account::Account(int account_id, int user_id, double initial_balance, AccountType type)
-    : account_id(account_id), user_id(user_id), balance(initial_balance), account_type(type) {
+Account::Account(int account_id, int user_id, Money initial_balance, AccountType type)
+    : account_id(account_id), user_id(user_id), balance_minor(initial_balance.minorUnits()), version(0),
+      account_type(type) {
     auto now = std::chrono::system_clock::now();
     auto time_t = std::chrono::system_clock::to_time_t(now);
     std::stringstream ss;
@@ -33,11 +34,11 @@ Account::~Account() {}
 // Move constructor
 Account::Account(Account&& other) noexcept
     : account_id(other.account_id), user_id(other.user_id), 
-      balance(other.balance), account_type(other.account_type),
+      balance_minor(other.balance_minor.load()), version(other.version.load()), account_type(other.account_type),
       created_at(std::move(other.created_at)) {
     other.account_id = 0;
     other.user_id = 0;
-    other.balance = 0.0;
+    other.balance_minor = 0;
 }
 
 // Move assignment operator
@@ -45,13 +46,14 @@ Account& Account::operator=(Account&& other) noexcept {
     if (this != &other) {
         account_id = other.account_id;
         user_id = other.user_id;
-        balance = other.balance;
+        balance_minor = other.balance_minor.load();
+        version++;
         account_type = other.account_type;
         created_at = std::move(other.created_at);
         
         other.account_id = 0;
         other.user_id = 0;
-        other.balance = 0.0;
+        other.balance_minor = 0;
     }
     return *this;
 }
@@ -65,15 +67,19 @@ int Account::getUserId() const {
     return user_id;
 }
 
-double Account::getBalance() const {
-    std::lock_guard<std::mutex> lock(account_mutex);
-    return balance;
+Money Account::getBalance() const {
+    int64_t current = balance_minor.load();
+    return current == CLOSED_BALANCE ? Money() : Money::fromMinorUnits(current);
 }
 
 AccountType Account::getAccountType() const {
     return account_type;
 }
 
+uint64_t Account::getVersion() const {
+    return version.load();
+}
+
 std::string Account::getCreatedAt() const {
     return created_at;
 }
@@ -91,91 +97,80 @@ void Account::setAccountType(AccountType type) {
     account_type = type;
 }
 
-void Account::setBalance(double new_balance) {
-    std::lock_guard<std::mutex> lock(account_mutex);
-    balance = new_balance;
+void Account::setBalance(Money new_balance) {
+    balance_minor = new_balance.minorUnits();
+    version++;
 }
 
-// Deposit operation
-TransactionStatus Account::deposit(double amount) {
+// Deposit operation (lock-free; persistence is the caller's job)
+TransactionStatus Account::deposit(Money amount) {
     if (!isValidAmount(amount)) {
         std::cerr << "Invalid deposit amount: $" << amount << std::endl;
         return TransactionStatus::FAILED;
     }
 
-    std::lock_guard<std::mutex> lock(account_mutex);
-
-    try {
-        double old_balance = balance;
-        balance += amount;
-        std::cout << "Deposit processed: $" << amount << " added to account " << account_id << std::endl;
-        std::cout << "New balance: $" << std::fixed << std::setprecision(2) << balance << std::endl;
-
-        // Sync balance using file-based synchronization (reliable across terminals)
-        std::cout << "Syncing account balance..." << std::endl;
-
-        // Use file-based sync to avoid database hanging issues
-        // This ensures synchronization across multiple terminal instances
-        std::ofstream sync_file("account_" + std::to_string(account_id) + "_balance.sync");
-        if (sync_file.is_open()) {
-            sync_file << std::fixed << std::setprecision(2) << balance;
-            sync_file.close();
-            std::cout << "Balance synchronized successfully" << std::endl;
-        } else {
-            std::cout << "Balance sync warning (continuing with operation)" << std::endl;
-        }
-
-        return TransactionStatus::SUCCESS;
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Deposit error: " << e.what() << std::endl;
+    if (!tryCredit(amount)) {
+        std::cerr << "Account " << account_id << " is closed" << std::endl;
         return TransactionStatus::FAILED;
     }
+    return TransactionStatus::SUCCESS;
 }
 
-// Withdraw operation
-TransactionStatus Account::withdraw(double amount) {
+// Withdraw operation (lock-free; the overdraft check is part of the CAS)
+TransactionStatus Account::withdraw(Money amount) {
     if (!isValidAmount(amount)) {
         std::cerr << "Invalid withdrawal amount: $" << amount << std::endl;
         return TransactionStatus::FAILED;
     }
 
-    std::lock_guard<std::mutex> lock(account_mutex);
+    if (!tryDebit(amount)) {
+        std::cerr << "Insufficient balance. Current balance: $" << getBalance() << std::endl;
+        return TransactionStatus::FAILED;
+    }
+    return TransactionStatus::SUCCESS;
+}
 
-    if (!hasSufficientBalance(amount)) {
-        std::cerr << "Insufficient balance. Current balance: $" << balance << std::endl;
+// Transfer operation
+TransactionStatus Account::transfer(std::shared_ptr<Account> to_account, Money amount) {
+    if (!to_account || !isValidAmount(amount)) {
+        std::cerr << "Invalid transfer parameters" << std::endl;
         return TransactionStatus::FAILED;
     }
 
-    try {
-        double old_balance = balance;
-        balance -= amount;
-        std::cout << "Withdrawal processed: $" << amount << " from account " << account_id << std::endl;
-        std::cout << "New balance: $" << std::fixed << std::setprecision(2) << balance << std::endl;
-
-        // Sync balance using file-based synchronization (reliable across terminals)
-        std::cout << "Syncing account balance..." << std::endl;
-
-        // Use file-based sync to avoid database hanging issues
-        std::ofstream sync_file("account_" + std::to_string(account_id) + "_balance.sync");
-        if (sync_file.is_open()) {
-            sync_file << std::fixed << std::setprecision(2) << balance;
-            sync_file.close();
-            std::cout << "Balance synchronized successfully" << std::endl;
-        } else {
-            std::cout << "Balance sync warning (continuing with operation)" << std::endl;
-        }
+    if (account_id == to_account->getAccountId()) {
+        std::cerr << "Cannot transfer to the same account" << std::endl;
+        return TransactionStatus::FAILED;
+    }
+
+    // Lock ordering to prevent deadlock (always lock smaller account_id first)
+    // This provides defense-in-depth along with BankSystem-level deadlock prevention.
+    // The mutexes only order transfers against each other; single-account
+    // deposits and withdrawals stay lock-free and see the balances through the atomics.
+    Account* first_lock = (account_id < to_account->getAccountId()) ? this : to_account.get();
+    Account* second_lock = (account_id < to_account->getAccountId()) ? to_account.get() : this;
+
+    std::lock_guard<std::mutex> lock1(first_lock->account_mutex);
+    std::lock_guard<std::mutex> lock2(second_lock->account_mutex);
 
-        return TransactionStatus::SUCCESS;
+    if (!tryDebit(amount)) {
+        std::cerr << "Insufficient balance for transfer. Current balance: $" << getBalance() << std::endl;
+        return TransactionStatus::FAILED;
     }
-    catch (const std::exception& e) {
-        std::cerr << "Withdrawal error: " << e.what() << std::endl;
+
+    if (!to_account->tryCredit(amount)) {
+        refundDebit(amount); // Destination was closed; give the money back
+        std::cerr << "Destination account " << to_account->getAccountId() << " is closed" << std::endl;
         return TransactionStatus::FAILED;
     }
+
+    return TransactionStatus::SUCCESS;
 }
 
-// Transfer operation (simplified to avoid hanging)
-TransactionStatus Account::transfer(std::shared_ptr<Account> to_account, double amount) {
+// Optimistic transfer: read the source without locking, then validate its version
+// and commit under the two mutexes. The debit only succeeds against the balance
+// that was read, so a lock-free withdrawal in between is a conflict. The
+// destination is not validated: credits commute, and tryCredit refuses a closed account.
+TransactionStatus Account::transferOptimistic(std::shared_ptr<Account> to_account, Money amount) {
     if (!to_account || !isValidAmount(amount)) {
         std::cerr << "Invalid transfer parameters" << std::endl;
         return TransactionStatus::FAILED;
@@ -186,80 +181,103 @@ TransactionStatus Account::transfer(std::shared_ptr<Account> to_account, double
         return TransactionStatus::FAILED;
     }
 
-    // Lock ordering to prevent deadlock (always lock smaller account_id first)
-    // This provides defense-in-depth along with BankSystem-level deadlock prevention
+    // Read phase
+    uint64_t from_version = version.load();
+    int64_t from_balance = balance_minor.load();
+    if (from_balance < amount.minorUnits()) {
+        std::cerr << "Insufficient balance for transfer. Current balance: $" << getBalance() << std::endl;
+        return TransactionStatus::FAILED;
+    }
+    if (to_account->isClosed()) {
+        std::cerr << "Destination account " << to_account->getAccountId() << " is closed" << std::endl;
+        return TransactionStatus::FAILED;
+    }
+
+    // Validate and commit
     Account* first_lock = (account_id < to_account->getAccountId()) ? this : to_account.get();
     Account* second_lock = (account_id < to_account->getAccountId()) ? to_account.get() : this;
 
     std::lock_guard<std::mutex> lock1(first_lock->account_mutex);
     std::lock_guard<std::mutex> lock2(second_lock->account_mutex);
 
-    if (!hasSufficientBalance(amount)) {
-        std::cerr << "Insufficient balance for transfer. Current balance: $" << balance << std::endl;
+    // close() needs the mutex, so the destination stays open from here on
+    if (to_account->isClosed()) {
+        std::cerr << "Destination account " << to_account->getAccountId() << " is closed" << std::endl;
+        return TransactionStatus::FAILED;
+    }
+    if (version.load() != from_version ||
+        !balance_minor.compare_exchange_strong(from_balance, from_balance - amount.minorUnits())) {
+        return TransactionStatus::PENDING;
+    }
+    version++;
+
+    if (!to_account->tryCredit(amount)) {
+        refundDebit(amount); // Closed since it was read; give the money back
+        std::cerr << "Destination account " << to_account->getAccountId() << " is closed" << std::endl;
         return TransactionStatus::FAILED;
     }
 
-    try {
-        // Store original balances for rollback
-        double old_from_balance = balance;
-        double old_to_balance = to_account->balance;
-
-        // Perform transfer
-        balance -= amount;
-        to_account->balance += amount;
-
-        std::cout << "Transfer processed: $" << amount << " from account " << account_id
-                  << " to account " << to_account->getAccountId() << std::endl;
-        std::cout << "Source account new balance: $" << std::fixed << std::setprecision(2) << balance << std::endl;
-        std::cout << "Destination account new balance: $" << std::fixed << std::setprecision(2) << to_account->balance << std::endl;
-
-        // Sync balances using file-based synchronization (reliable across terminals)
-        std::cout << "Syncing account balances..." << std::endl;
-
-        // Sync both account balances to files
-        std::ofstream from_sync("account_" + std::to_string(account_id) + "_balance.sync");
-        std::ofstream to_sync("account_" + std::to_string(to_account->getAccountId()) + "_balance.sync");
-
-        bool sync_success = true;
-        if (from_sync.is_open()) {
-            from_sync << std::fixed << std::setprecision(2) << balance;
-            from_sync.close();
-        } else {
-            sync_success = false;
-        }
+    return TransactionStatus::SUCCESS;
+}
 
-        if (to_sync.is_open()) {
-            to_sync << std::fixed << std::setprecision(2) << to_account->balance;
-            to_sync.close();
-        } else {
-            sync_success = false;
+// Add to the balance unless the account has been closed
+bool Account::tryCredit(Money amount) {
+    int64_t current = balance_minor.load();
+    do {
+        if (current == CLOSED_BALANCE) {
+            return false;
         }
+    } while (!balance_minor.compare_exchange_weak(current, current + amount.minorUnits()));
+    version++;
+    return true;
+}
 
-        if (sync_success) {
-            std::cout << "Balances synchronized successfully" << std::endl;
-        } else {
-            std::cout << "Balance sync warning (continuing with operation)" << std::endl;
+// Subtract from the balance only if it stays non-negative (a closed account never qualifies)
+bool Account::tryDebit(Money amount) {
+    int64_t current = balance_minor.load();
+    do {
+        if (current < amount.minorUnits()) {
+            return false;
         }
+    } while (!balance_minor.compare_exchange_weak(current, current - amount.minorUnits()));
+    version++;
+    return true;
+}
 
-        return TransactionStatus::SUCCESS;
+// Return a transfer's debit. tryCredit refuses a closed account, so the refund can
+// never turn the closed marker back into a balance; the caller holds account_mutex,
+// which close() needs, so it cannot close in between anyway.
+void Account::refundDebit(Money amount) {
+    if (!tryCredit(amount)) {
+        std::cerr << "Account " << account_id << " closed before $" << amount << " could be refunded" << std::endl;
     }
-    catch (const std::exception& e) {
-        std::cerr << "Transfer error: " << e.what() << std::endl;
-        balance += amount;
-        to_account->balance -= amount;
-        return TransactionStatus::FAILED;
+}
+
+// Close an empty account; afterwards every credit and debit fails.
+// Takes account_mutex so an account cannot close in the middle of a transfer.
+bool Account::close() {
+    std::lock_guard<std::mutex> lock(account_mutex);
+    int64_t expected = 0;
+    if (!balance_minor.compare_exchange_strong(expected, CLOSED_BALANCE)) {
+        return false;
     }
+    version++;
+    return true;
+}
+
+bool Account::isClosed() const {
+    return balance_minor.load() == CLOSED_BALANCE;
 }
 
 // Check sufficient balance
-bool Account::hasSufficientBalance(double amount) const {
-    return balance >= amount;
+bool Account::hasSufficientBalance(Money amount) const {
+    return balance_minor.load() >= amount.minorUnits();
 }
 
 // Update balance (internal use)
-void Account::updateBalance(double new_balance) {
-    std::lock_guard<std::mutex> lock(account_mutex);
-    balance = new_balance;
+void Account::updateBalance(Money new_balance) {
+    balance_minor = new_balance.minorUnits();
+    version++;
 }
 
 // Locking mechanisms
@@ -280,24 +298,22 @@ std::mutex& Account::getMutex() const {
 }
 
 // Validate amount
-bool Account::isValidAmount(double amount) {
+bool Account::isValidAmount(Money amount) {
     return Security::isValidAmount(amount);
 }
 
 // Check if withdrawal is allowed
-bool Account::canWithdraw(double amount) const {
-    std::lock_guard<std::mutex> lock(account_mutex);
+bool Account::canWithdraw(Money amount) const {
     return hasSufficientBalance(amount);
 }
 
 // Display account information
 void Account::displayAccountInfo() const {
-    std::lock_guard<std::mutex> lock(account_mutex);
     std::cout << "=== Account Information ===" << std::endl;
     std::cout << "Account ID: " << account_id << std::endl;
     std::cout << "User ID: " << user_id << std::endl;
     std::cout << "Account Type: " << getAccountTypeString() << std::endl;
-    std::cout << "Balance: $" << std::fixed << std::setprecision(2) << balance << std::endl;
+    std::cout << "Balance: $" << getBalance() << std::endl;
     std::cout << "Created: " << created_at << std::endl;
     std::cout << "===========================" << std::endl;
 }
@@ -315,13 +331,16 @@ std::string Account::getAccountTypeString() const {
 }
 
 // Calculate interest for savings accounts
-double Account::calculateInterest(double rate, int days) const {
+Money Account::calculateInterest(double rate, int days) const {
     if (account_type != AccountType::SAVINGS) {
-        return 0.0;
+        return Money();
     }
-    
-    std::lock_guard<std::mutex> lock(account_mutex);
-    return (balance * rate * days) / 365.0;
+
+    // Rate in parts per million keeps the calculation in exact integer arithmetic
+    const int64_t RATE_SCALE = 1000000;
+    int64_t rate_ppm = static_cast<int64_t>(std::llround(rate * RATE_SCALE));
+
+    return getBalance().multiplyRatio(rate_ppm * days, RATE_SCALE * 365);
 }
 
 // Apply interest to account
@@ -330,8 +349,13 @@ void Account::applyInterest(double rate) {
         return;
     }
     
-    double interest = calculateInterest(rate, 30); // Monthly interest
-    deposit(interest);
+    Money interest = calculateInterest(rate, BankingConstants::MONTHLY_INTEREST_DAYS);
+    postInterest(interest);
+}
+
+// Credit interest (fails only for a closed account or a non-positive amount)
+bool Account::postInterest(Money interest) {
+    return interest.isPositive() && tryCredit(interest);
 }
 
 // Get transaction history
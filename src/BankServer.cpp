@@ -3,13 +3,42 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+#include <cerrno>
 #include <iostream>
 #include <cstring>
 #include <algorithm>
 #include <ctime>
 
-BankServer::BankServer(int port)
-    : bank_system(BankSystem::getInstance()), server_socket(-1), port(port), running(false) {
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // Not available on macOS; SIGPIPE stays at its default there
+#endif
+
+// Reactor defaults
+static const size_t DEFAULT_IO_THREADS = 2;
+static const size_t DEFAULT_WORKER_THREADS = 8;
+static const size_t WORKER_QUEUE_CAPACITY = 4096;
+static const int MAX_EPOLL_EVENTS = 256;
+static const int SEND_POLL_TIMEOUT_MS = 5000;
+static const size_t MAX_PENDING_OUTPUT = 1 << 20; // Stop reading a client that leaves this much unread
+static const int PAUSED_RETRY_MS = 10;            // How often paused connections retry the worker pool
+
+// Close the socket once no I/O thread or worker references the connection
+ClientConnection::~ClientConnection() {
+    if (socket >= 0) {
+        close(socket);
+    }
+}
+
+BankServer::BankServer(int port, ServerMode mode)
+    : bank_system(BankSystem::getInstance()), server_socket(-1), port(port), running(false),
+      stop_requested(false), mode(mode), io_thread_count(DEFAULT_IO_THREADS), worker_thread_count(DEFAULT_WORKER_THREADS),
+      next_io_loop(0) {
 }
 
 BankServer::~BankServer() {
@@ -27,8 +56,24 @@ bool BankServer::start() {
         return false;
     }
     
+    stop_requested = false;
     running = true;
+
+    // Pipelined requests are answered by the worker pool in both modes
+    worker_pool = std::make_unique<ThreadPool>(worker_thread_count, WORKER_QUEUE_CAPACITY);
+
+    if (mode == ServerMode::EPOLL_REACTOR && !startReactor()) {
+        running = false;
+        worker_pool.reset();
+        cleanupSocket();
+        return false;
+    }
+
     std::cout << "Bank Server started on port " << port << std::endl;
+    if (mode == ServerMode::EPOLL_REACTOR) {
+        std::cout << "Reactor mode: " << io_loops.size() << " I/O threads, "
+                  << worker_pool->getThreadCount() << " worker threads" << std::endl;
+    }
     std::cout << "Waiting for ATM connections..." << std::endl;
     
     // Accept client connections
@@ -38,13 +83,18 @@ bool BankServer::start() {
         
         int client_socket = accept(server_socket, (struct sockaddr*)&client_addr, &client_len);
         if (client_socket < 0) {
-            if (running) {
+            if (running && !stop_requested) {
                 std::cerr << "Failed to accept client connection" << std::endl;
             }
             continue;
         }
         
         std::cout << "New ATM connected from " << inet_ntoa(client_addr.sin_addr) << std::endl;
+
+        if (mode == ServerMode::EPOLL_REACTOR) {
+            acceptReactorClient(client_socket);
+            continue;
+        }
         
         // Store client socket
         {
@@ -55,22 +105,36 @@ bool BankServer::start() {
         // Handle client in separate thread
         client_threads.emplace_back(&BankServer::handleClient, this, client_socket);
     }
-    
+
+    teardown();
     return true;
 }
 
-// Stop the server
+// Request shutdown; only flags the server and wakes accept, so it is safe from a signal handler
 void BankServer::stop() {
-    if (!running) return;
-    
+    if (!running || stop_requested.exchange(true)) return;
+
+    // Wake the accept loop before clearing running: once start() sees running
+    // clear it closes server_socket and tears everything down
+    if (server_socket >= 0) {
+        shutdown(server_socket, SHUT_RDWR);
+    }
     running = false;
+}
+
+// Tear down the reactor, client threads and worker pool on the thread that ran start()
+void BankServer::teardown() {
     std::cout << "Stopping Bank Server..." << std::endl;
+
+    if (mode == ServerMode::EPOLL_REACTOR) {
+        stopReactor();
+    }
     
-    // Close all client connections
+    // Disconnect all clients (each handler thread closes its own socket)
     {
         std::lock_guard<std::mutex> lock(client_mutex);
         for (int socket : client_sockets) {
-            close(socket);
+            shutdown(socket, SHUT_RDWR);
         }
         client_sockets.clear();
     }
@@ -82,22 +146,55 @@ void BankServer::stop() {
         }
     }
     client_threads.clear();
+
+    // Finish requests that are still queued
+    if (worker_pool) {
+        worker_pool->shutdown();
+        worker_pool.reset();
+    }
     
     cleanupSocket();
     std::cout << "Bank Server stopped" << std::endl;
 }
 
+// Configure number of reactor I/O threads
+void BankServer::setIoThreadCount(size_t count) {
+    io_thread_count = count == 0 ? 1 : count;
+}
+
+// Configure number of reactor worker threads
+void BankServer::setWorkerThreadCount(size_t count) {
+    worker_thread_count = count == 0 ? 1 : count;
+}
+
 // Handle individual client
 void BankServer::handleClient(int client_socket) {
     std::cout << "Handling ATM client on socket " << client_socket << std::endl;
+
+    auto connection = std::make_shared<ClientConnection>(client_socket);
+    FrameDecoder decoder;
+    std::string encrypted_message;
+    uint32_t request_id = 0;
     
     while (running) {
-        std::string encrypted_message = receiveMessage(client_socket);
-        if (encrypted_message.empty()) {
+        if (!receiveData(client_socket, decoder)) {
             break; // Client disconnected
         }
-        
-        processMessage(client_socket, encrypted_message);
+
+        // One read may carry several requests, or only part of one
+        while (decoder.nextFrame(encrypted_message, request_id)) {
+            if (request_id == 0) {
+                // Non-pipelining client: answer in order on this thread
+                sendResponse(connection, buildResponse(encrypted_message), request_id);
+            } else {
+                dispatchMessage(connection, std::move(encrypted_message), request_id);
+            }
+        }
+
+        if (decoder.isCorrupted()) {
+            std::cerr << "Malformed frame from socket " << client_socket << ", closing connection" << std::endl;
+            break;
+        }
     }
     
     // Remove client socket from tracking
@@ -109,12 +206,19 @@ void BankServer::handleClient(int client_socket) {
         );
     }
     
-    close(client_socket);
+    // Socket closes once in-flight pipelined replies have been written; a client
+    // that half-closed after its pipeline still gets every answer
+    connection.reset();
     std::cout << "ATM client disconnected from socket " << client_socket << std::endl;
 }
 
 // Process encrypted message from client
 void BankServer::processMessage(int client_socket, const std::string& encrypted_message) {
+    sendMessage(client_socket, buildResponse(encrypted_message));
+}
+
+// Decrypt a request, dispatch it to its handler and return the encrypted response
+std::string BankServer::buildResponse(const std::string& encrypted_message) {
     try {
         // Decrypt the message
         std::string decrypted = Encryption::decodeAndDecrypt(encrypted_message);
@@ -144,15 +248,13 @@ void BankServer::processMessage(int client_socket, const std::string& encrypted_
                 break;
         }
         
-        // Encrypt and send response
-        std::string encrypted_response = Encryption::encryptAndEncode(response_json);
-        sendMessage(client_socket, encrypted_response);
+        // Encrypt response
+        return Encryption::encryptAndEncode(response_json);
         
     } catch (const std::exception& e) {
         std::cerr << "Error processing message: " << e.what() << std::endl;
         std::string error_response = createErrorResponse("PROCESSING_ERROR", e.what());
-        std::string encrypted_error = Encryption::encryptAndEncode(error_response);
-        sendMessage(client_socket, encrypted_error);
+        return Encryption::encryptAndEncode(error_response);
     }
 }
 
@@ -162,24 +264,22 @@ std::string BankServer::handleLoginRequest(const std::string& json_payload) {
         LoginRequest request = JsonHandler::deserializeLoginRequest(json_payload);
         std::cout << "Login attempt from ATM " << request.atm_id << " for user: " << request.email << std::endl;
 
-        // Authenticate user
-        if (bank_system.authenticateUser(request.email, request.password)) {
-            auto user = bank_system.getCurrentUser();
-            if (user) {
-                // Create session
-                std::string session_token = createSession(user->getUserId(), request.atm_id);
-
-                LoginResponse response;
-                response.success = true;
-                response.message = "Login successful";
-                response.user_name = user->getName();
-                response.user_id = user->getUserId();
-                response.session_token = session_token;
-
-                std::cout << "Login successful for user: " << user->getName() << std::endl;
-                return JsonHandler::createNetworkMessage(MessageType::LOGIN_RESPONSE,
-                                                       JsonHandler::serializeLoginResponse(response));
-            }
+        // Authenticate user (the session, not BankSystem, remembers who logged in)
+        auto user = bank_system.authenticate(request.email, request.password);
+        if (user) {
+            // Create session
+            std::string session_token = createSession(user->getUserId(), request.atm_id);
+
+            LoginResponse response;
+            response.success = true;
+            response.message = "Login successful";
+            response.user_name = user->getName();
+            response.user_id = user->getUserId();
+            response.session_token = session_token;
+
+            std::cout << "Login successful for user: " << user->getName() << std::endl;
+            return JsonHandler::createNetworkMessage(MessageType::LOGIN_RESPONSE,
+                                                   JsonHandler::serializeLoginResponse(response));
         }
 
         LoginResponse response;
@@ -203,25 +303,26 @@ std::string BankServer::handleBalanceRequest(const std::string& json_payload) {
     try {
         BalanceRequest request = JsonHandler::deserializeBalanceRequest(json_payload);
 
-        if (!validateSession(request.session_token)) {
+        SessionInfo session;
+        if (!lookupSession(request.session_token, session)) {
             BalanceResponse response;
             response.success = false;
             response.message = "Invalid session";
-            response.balance = 0.0;
+            response.balance = Money();
             response.account_type = "";
 
             return JsonHandler::createNetworkMessage(MessageType::BALANCE_RESPONSE,
                                                    JsonHandler::serializeBalanceResponse(response));
         }
 
-        int user_id = getUserIdFromSession(request.session_token);
+        int user_id = session.user_id;
 
         // Validate account ownership
         if (!bank_system.validateAccountOwnership(request.account_id, user_id)) {
             BalanceResponse response;
             response.success = false;
             response.message = "Account access denied";
-            response.balance = 0.0;
+            response.balance = Money();
             response.account_type = "";
 
             return JsonHandler::createNetworkMessage(MessageType::BALANCE_RESPONSE,
@@ -245,7 +346,7 @@ std::string BankServer::handleBalanceRequest(const std::string& json_payload) {
         BalanceResponse response;
         response.success = false;
         response.message = "Account not found";
-        response.balance = 0.0;
+        response.balance = Money();
         response.account_type = "";
 
         return JsonHandler::createNetworkMessage(MessageType::BALANCE_RESPONSE,
@@ -261,25 +362,26 @@ std::string BankServer::handleWithdrawRequest(const std::string& json_payload) {
     try {
         WithdrawRequest request = JsonHandler::deserializeWithdrawRequest(json_payload);
 
-        if (!validateSession(request.session_token)) {
+        SessionInfo session;
+        if (!lookupSession(request.session_token, session)) {
             WithdrawResponse response;
             response.success = false;
             response.message = "Invalid session";
-            response.new_balance = 0.0;
+            response.new_balance = Money();
             response.transaction_id = "";
 
             return JsonHandler::createNetworkMessage(MessageType::WITHDRAW_RESPONSE,
                                                    JsonHandler::serializeWithdrawResponse(response));
         }
 
-        int user_id = getUserIdFromSession(request.session_token);
+        int user_id = session.user_id;
 
         // Validate account ownership
         if (!bank_system.validateAccountOwnership(request.account_id, user_id)) {
             WithdrawResponse response;
             response.success = false;
             response.message = "Account access denied";
-            response.new_balance = 0.0;
+            response.new_balance = Money();
             response.transaction_id = "";
 
             return JsonHandler::createNetworkMessage(MessageType::WITHDRAW_RESPONSE,
@@ -289,13 +391,13 @@ std::string BankServer::handleWithdrawRequest(const std::string& json_payload) {
         // Perform withdrawal
         std::cout << "Processing withdrawal: $" << request.amount << " from account " << request.account_id << std::endl;
 
-        if (bank_system.withdraw(request.account_id, request.amount)) {
+        if (bank_system.withdraw(user_id, request.account_id, request.amount)) {
             auto account = bank_system.getAccount(request.account_id);
 
             WithdrawResponse response;
             response.success = true;
             response.message = "Withdrawal successful";
-            response.new_balance = account ? account->getBalance() : 0.0;
+            response.new_balance = account ? account->getBalance() : Money();
             response.transaction_id = "TXN-" + std::to_string(std::time(nullptr));
 
             std::cout << "Withdrawal successful. New balance: $" << response.new_balance << std::endl;
@@ -305,7 +407,7 @@ std::string BankServer::handleWithdrawRequest(const std::string& json_payload) {
             WithdrawResponse response;
             response.success = false;
             response.message = "Withdrawal failed - insufficient funds or invalid amount";
-            response.new_balance = 0.0;
+            response.new_balance = Money();
             response.transaction_id = "";
 
             std::cout << "Withdrawal failed for account " << request.account_id << std::endl;
@@ -323,9 +425,7 @@ std::string BankServer::handleLogoutRequest(const std::string& json_payload) {
     try {
         LogoutRequest request = JsonHandler::deserializeLogoutRequest(json_payload);
 
-        if (validateSession(request.session_token)) {
-            removeSession(request.session_token);
-            bank_system.logout();
+        if (removeSession(request.session_token)) {
 
             LogoutResponse response;
             response.success = true;
@@ -350,52 +450,30 @@ std::string BankServer::handleLogoutRequest(const std::string& json_payload) {
 
 // Session management methods
 std::string BankServer::createSession(int user_id, const std::string& atm_id) {
-    std::lock_guard<std::mutex> lock(session_mutex);
-
     std::string token = Encryption::generateSessionToken();
-    active_sessions.push_back({token, user_id});
-    session_atm_map.push_back({token, atm_id});
+    sessions.insert(token, user_id, atm_id);
 
     std::cout << "Created session for user " << user_id << " from ATM " << atm_id << std::endl;
     return token;
 }
 
+// Single lookup returning both the user and the ATM bound to a token
+bool BankServer::lookupSession(const std::string& token, SessionInfo& info) {
+    return sessions.lookup(token, info);
+}
+
 bool BankServer::validateSession(const std::string& token) {
-    std::lock_guard<std::mutex> lock(session_mutex);
-    for (const auto& session : active_sessions) {
-        if (session.first == token) {
-            return true;
-        }
-    }
-    return false;
+    SessionInfo info;
+    return sessions.lookup(token, info);
 }
 
 int BankServer::getUserIdFromSession(const std::string& token) {
-    std::lock_guard<std::mutex> lock(session_mutex);
-    for (const auto& session : active_sessions) {
-        if (session.first == token) {
-            return session.second;
-        }
-    }
-    return 0;
+    SessionInfo info;
+    return sessions.lookup(token, info) ? info.user_id : 0;
 }
 
-void BankServer::removeSession(const std::string& token) {
-    std::lock_guard<std::mutex> lock(session_mutex);
-
-    // Remove from active_sessions
-    active_sessions.erase(
-        std::remove_if(active_sessions.begin(), active_sessions.end(),
-                      [&token](const auto& session) { return session.first == token; }),
-        active_sessions.end()
-    );
-
-    // Remove from session_atm_map
-    session_atm_map.erase(
-        std::remove_if(session_atm_map.begin(), session_atm_map.end(),
-                      [&token](const auto& session) { return session.first == token; }),
-        session_atm_map.end()
-    );
+bool BankServer::removeSession(const std::string& token) {
+    return sessions.remove(token);
 }
 
 // Socket operations
@@ -444,23 +522,84 @@ void BankServer::cleanupSocket() {
     }
 }
 
-// Receive message from client
-std::string BankServer::receiveMessage(int client_socket) {
-    char buffer[MAX_MESSAGE_SIZE];
-    memset(buffer, 0, sizeof(buffer));
+// Receive available bytes from client into its reassembly buffer
+bool BankServer::receiveData(int client_socket, FrameDecoder& decoder) {
+    char buffer[RECV_BUFFER_SIZE];
+
+    ssize_t bytes_received;
+    do {
+        bytes_received = recv(client_socket, buffer, sizeof(buffer), 0);
+    } while (bytes_received < 0 && errno == EINTR);
 
-    ssize_t bytes_received = recv(client_socket, buffer, sizeof(buffer) - 1, 0);
     if (bytes_received <= 0) {
-        return ""; // Client disconnected or error
+        return false; // Client disconnected or error
     }
 
-    return std::string(buffer, bytes_received);
+    decoder.append(buffer, bytes_received);
+    return true;
 }
 
-// Send message to client
-bool BankServer::sendMessage(int client_socket, const std::string& message) {
-    ssize_t bytes_sent = send(client_socket, message.c_str(), message.length(), 0);
-    return bytes_sent == static_cast<ssize_t>(message.length());
+// Send framed message to client (handles partial writes and non-blocking sockets)
+bool BankServer::sendMessage(int client_socket, const std::string& payload, uint32_t request_id) {
+    std::string message = encodeFrame(payload, request_id);
+    size_t total_sent = 0;
+    while (total_sent < message.length()) {
+        ssize_t bytes_sent = send(client_socket, message.data() + total_sent,
+                                  message.length() - total_sent, MSG_NOSIGNAL);
+        if (bytes_sent > 0) {
+            total_sent += static_cast<size_t>(bytes_sent);
+            continue;
+        }
+
+        if (bytes_sent < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (bytes_sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // Socket buffer full - wait until the peer drains it
+            struct pollfd pfd;
+            pfd.fd = client_socket;
+            pfd.events = POLLOUT;
+            pfd.revents = 0;
+            if (poll(&pfd, 1, SEND_POLL_TIMEOUT_MS) <= 0) {
+                return false;
+            }
+            continue;
+        }
+
+        return false;
+    }
+    return true;
+}
+
+// Hand a request to the worker pool; the reply is written by the worker.
+// Requests from one connection run concurrently and may complete out of order.
+void BankServer::dispatchMessage(const std::shared_ptr<ClientConnection>& connection,
+                                 std::string encrypted_message, uint32_t request_id) {
+    bool queued = worker_pool->submit([this, connection, request_id, message = std::move(encrypted_message)]() {
+        if (connection->closed) {
+            return;
+        }
+        sendResponse(connection, buildResponse(message), request_id);
+    });
+
+    if (!queued) {
+        std::cerr << "Worker pool stopped, dropping request" << std::endl;
+    }
+}
+
+// Write one response frame; concurrent replies on a connection are serialized
+void BankServer::sendResponse(const std::shared_ptr<ClientConnection>& connection,
+                              const std::string& response, uint32_t request_id) {
+    if (connection->loop) {
+        queueReply(connection, response, request_id);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(connection->write_mutex);
+    if (!connection->closed && !sendMessage(connection->socket, response, request_id)) {
+        connection->closed = true;
+    }
 }
 
 // Create error response
@@ -475,23 +614,478 @@ std::string BankServer::createErrorResponse(const std::string& error_code, const
 
 // Display server statistics
 void BankServer::displayServerStats() const {
-    // Create non-const reference for locking
-    std::mutex& session_mut = const_cast<std::mutex&>(session_mutex);
+    // Create non-const references for locking and counting
     std::mutex& client_mut = const_cast<std::mutex&>(client_mutex);
+    SessionStore& session_store = const_cast<SessionStore&>(sessions);
 
-    std::lock_guard<std::mutex> session_lock(session_mut);
     std::lock_guard<std::mutex> client_lock(client_mut);
 
     std::cout << "\n=== Bank Server Statistics ===" << std::endl;
-    std::cout << "Active ATM connections: " << client_sockets.size() << std::endl;
-    std::cout << "Active sessions: " << active_sessions.size() << std::endl;
+    std::cout << "Active ATM connections: " << client_sockets.size() + connections.size() << std::endl;
+    std::cout << "Active sessions: " << session_store.size() << std::endl;
+    std::cout << "Expired sessions: " << session_store.getExpiredCount() << std::endl;
     std::cout << "Server port: " << port << std::endl;
     std::cout << "Server status: " << (running ? "Running" : "Stopped") << std::endl;
+    if (mode == ServerMode::EPOLL_REACTOR) {
+        std::cout << "Server mode: epoll reactor (" << io_loops.size() << " I/O threads)" << std::endl;
+    } else {
+        std::cout << "Server mode: thread per client" << std::endl;
+    }
+    if (worker_pool) {
+        ThreadPool& pool = const_cast<ThreadPool&>(*worker_pool);
+        std::cout << "Worker threads: " << pool.getThreadCount() << std::endl;
+        std::cout << "Queued requests: " << pool.getQueuedTaskCount() << std::endl;
+        std::cout << "Requests processed by workers: " << pool.getTasksCompleted() << std::endl;
+    }
 }
 
 // Get active client count
 int BankServer::getActiveClientCount() const {
     std::mutex& client_mut = const_cast<std::mutex&>(client_mutex);
     std::lock_guard<std::mutex> lock(client_mut);
-    return client_sockets.size();
+    return client_sockets.size() + connections.size();
 }
+
+// ===== Reactor mode =====
+#ifdef __linux__
+
+// Create the worker pool and one epoll instance per I/O thread
+bool BankServer::startReactor() {
+    for (size_t i = 0; i < io_thread_count; ++i) {
+        auto loop = std::make_unique<IoLoop>();
+        loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        loop->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (loop->epoll_fd < 0 || loop->wake_fd < 0) {
+            std::cerr << "Failed to create epoll instance" << std::endl;
+            if (loop->epoll_fd >= 0) close(loop->epoll_fd);
+            if (loop->wake_fd >= 0) close(loop->wake_fd);
+            stopReactor();
+            return false;
+        }
+
+        // The wake descriptor is registered with a null pointer to tell it apart from clients
+        struct epoll_event wake_event;
+        memset(&wake_event, 0, sizeof(wake_event));
+        wake_event.events = EPOLLIN;
+        wake_event.data.ptr = nullptr;
+        epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, loop->wake_fd, &wake_event);
+
+        io_loops.push_back(std::move(loop));
+    }
+
+    for (auto& loop : io_loops) {
+        loop->thread = std::thread(&BankServer::runIoLoop, this, loop.get());
+    }
+
+    return true;
+}
+
+// Stop I/O threads, drain outstanding requests and drop all connections
+void BankServer::stopReactor() {
+    for (auto& loop : io_loops) {
+        uint64_t one = 1;
+        if (write(loop->wake_fd, &one, sizeof(one)) < 0) {
+            std::cerr << "Failed to wake I/O thread" << std::endl;
+        }
+    }
+
+    for (auto& loop : io_loops) {
+        if (loop->thread.joinable()) {
+            loop->thread.join();
+        }
+    }
+
+    // Workers check closed under write_mutex before touching an IoLoop, so once
+    // every connection is closed the loops can go
+    {
+        std::lock_guard<std::mutex> lock(client_mutex);
+        for (auto& [socket, connection] : connections) {
+            {
+                std::lock_guard<std::mutex> write_lock(connection->write_mutex);
+                connection->closed = true;
+            }
+            connection->backlog.clear();
+        }
+        connections.clear();
+    }
+
+    for (auto& loop : io_loops) {
+        close(loop->epoll_fd);
+        close(loop->wake_fd);
+    }
+    io_loops.clear();
+}
+
+// Register a freshly accepted socket with one of the I/O threads
+void BankServer::acceptReactorClient(int client_socket) {
+    int flags = fcntl(client_socket, F_GETFL, 0);
+    if (flags < 0 || fcntl(client_socket, F_SETFL, flags | O_NONBLOCK) < 0) {
+        std::cerr << "Failed to make client socket non-blocking" << std::endl;
+        close(client_socket);
+        return;
+    }
+
+    auto connection = std::make_shared<ClientConnection>(client_socket);
+    IoLoop* loop = io_loops[next_io_loop++ % io_loops.size()].get();
+    connection->loop = loop;
+    connection->registered = true;
+
+    {
+        std::lock_guard<std::mutex> lock(client_mutex);
+        connections[client_socket] = connection;
+    }
+
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+    event.data.ptr = connection.get();
+
+    if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, client_socket, &event) < 0) {
+        std::cerr << "Failed to register client socket " << client_socket << " with epoll" << std::endl;
+        connection->registered = false;
+        std::lock_guard<std::mutex> lock(client_mutex);
+        connections.erase(client_socket);
+    }
+}
+
+// I/O thread main loop
+void BankServer::runIoLoop(IoLoop* loop) {
+    struct epoll_event events[MAX_EPOLL_EVENTS];
+
+    while (running) {
+        int timeout = loop->paused.empty() ? -1 : PAUSED_RETRY_MS;
+        int ready = epoll_wait(loop->epoll_fd, events, MAX_EPOLL_EVENTS, timeout);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "epoll_wait failed" << std::endl;
+            break;
+        }
+
+        for (int i = 0; i < ready; ++i) {
+            if (events[i].data.ptr == nullptr) {
+                // Wake-up from a worker or stop(); pending replies are flushed below
+                uint64_t count;
+                if (read(loop->wake_fd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+                    std::cerr << "Failed to read I/O thread wake-up" << std::endl;
+                }
+                continue;
+            }
+
+            // Keep the connection alive even if handling this event closes it
+            auto connection = static_cast<ClientConnection*>(events[i].data.ptr)->shared_from_this();
+            if (events[i].events & EPOLLOUT) {
+                flushOutput(loop, connection.get());
+            }
+            if (connection->registered && !connection->read_paused && !connection->peer_closed &&
+                (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))) {
+                readFromConnection(loop, connection.get());
+            }
+        }
+
+        // Replies workers could not finish writing, and connections they closed
+        std::vector<std::shared_ptr<ClientConnection>> pending;
+        {
+            std::lock_guard<std::mutex> lock(loop->pending_mutex);
+            pending.swap(loop->pending);
+        }
+        for (auto& connection : pending) {
+            if (connection->registered) {
+                flushOutput(loop, connection.get());
+            }
+        }
+
+        resumePausedConnections(loop);
+    }
+}
+
+// Drain a readable socket (edge-triggered: read until EAGAIN). Reading pauses while
+// the worker pool is full or the client is not taking its replies.
+void BankServer::readFromConnection(IoLoop* loop, ClientConnection* connection) {
+    char buffer[RECV_BUFFER_SIZE];
+    std::string encrypted_message;
+    uint32_t request_id = 0;
+    auto self = connection->shared_from_this();
+
+    while (true) {
+        size_t unsent;
+        {
+            std::lock_guard<std::mutex> lock(connection->write_mutex);
+            unsent = connection->output.size();
+        }
+        if (!submitBacklog(connection) || unsent > MAX_PENDING_OUTPUT) {
+            if (!connection->read_paused) {
+                connection->read_paused = true;
+                loop->paused.push_back(self);
+            }
+            return; // Whatever is left stays in the socket buffer until we resume
+        }
+
+        ssize_t bytes_received = recv(connection->socket, buffer, sizeof(buffer), 0);
+
+        if (bytes_received > 0) {
+            connection->decoder.append(buffer, bytes_received);
+            while (connection->decoder.nextFrame(encrypted_message, request_id)) {
+                queueRequest(connection, std::move(encrypted_message), request_id);
+            }
+
+            if (connection->decoder.isCorrupted()) {
+                std::cerr << "Malformed frame from socket " << connection->socket << ", closing connection" << std::endl;
+                closeConnection(loop, connection);
+                return;
+            }
+            continue;
+        }
+
+        if (bytes_received < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (bytes_received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return; // Fully drained
+        }
+
+        if (bytes_received < 0) {
+            closeConnection(loop, connection);
+            return;
+        }
+
+        // Orderly shutdown: queued requests are still answered, then the connection closes
+        {
+            std::lock_guard<std::mutex> lock(connection->write_mutex);
+            connection->peer_closed = true;
+        }
+        flushOutput(loop, connection);
+        return;
+    }
+}
+
+// Queue a decoded request for the worker pool. Pipelined requests run concurrently;
+// id-0 requests join the connection's ordered queue and are answered one at a time.
+void BankServer::queueRequest(ClientConnection* connection, std::string encrypted_message, uint32_t request_id) {
+    auto self = connection->shared_from_this();
+    connection->in_flight++;
+
+    if (request_id != 0) {
+        connection->backlog.emplace_back([this, self, request_id, message = std::move(encrypted_message)]() {
+            if (self->closed) {
+                return;
+            }
+            sendResponse(self, buildResponse(message), request_id);
+        });
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(connection->ordered_mutex);
+        connection->ordered_requests.push_back(std::move(encrypted_message));
+        if (connection->ordered_running) {
+            return; // The pending drain task picks it up
+        }
+        connection->ordered_running = true;
+    }
+    connection->backlog.emplace_back([this, self]() { drainOrderedRequests(self); });
+}
+
+// Worker side: answer a connection's id-0 requests in arrival order
+void BankServer::drainOrderedRequests(const std::shared_ptr<ClientConnection>& connection) {
+    std::string encrypted_message;
+    while (!connection->closed) {
+        {
+            std::lock_guard<std::mutex> lock(connection->ordered_mutex);
+            if (connection->ordered_requests.empty()) {
+                connection->ordered_running = false;
+                return;
+            }
+            encrypted_message = std::move(connection->ordered_requests.front());
+            connection->ordered_requests.pop_front();
+        }
+        sendResponse(connection, buildResponse(encrypted_message), 0);
+    }
+}
+
+// Hand queued requests to the worker pool without blocking; false if it is full
+bool BankServer::submitBacklog(ClientConnection* connection) {
+    while (!connection->backlog.empty()) {
+        if (!worker_pool->trySubmit(connection->backlog.front())) {
+            return false;
+        }
+        connection->backlog.pop_front();
+    }
+    return true;
+}
+
+// Retry paused connections; each resumes reading once its requests fit in the pool
+void BankServer::resumePausedConnections(IoLoop* loop) {
+    if (loop->paused.empty()) {
+        return;
+    }
+
+    std::vector<std::shared_ptr<ClientConnection>> paused;
+    paused.swap(loop->paused);
+    for (auto& connection : paused) {
+        if (!connection->registered) {
+            continue;
+        }
+        connection->read_paused = false;
+        readFromConnection(loop, connection.get()); // Pauses it again if there is still no room
+    }
+}
+
+// Worker side of a reply: write what the socket takes now and leave the rest to the
+// I/O thread. Never blocks, so a slow client cannot tie up a worker.
+void BankServer::queueReply(const std::shared_ptr<ClientConnection>& connection,
+                            const std::string& response, uint32_t request_id) {
+    std::string frame = encodeFrame(response, request_id);
+
+    std::lock_guard<std::mutex> lock(connection->write_mutex);
+    if (connection->closed) {
+        return;
+    }
+
+    bool notify = false;
+    if (connection->output.empty()) {
+        // Nothing queued ahead of this reply
+        size_t sent = 0;
+        while (sent < frame.size()) {
+            ssize_t bytes_sent = send(connection->socket, frame.data() + sent, frame.size() - sent, MSG_NOSIGNAL);
+            if (bytes_sent > 0) {
+                sent += static_cast<size_t>(bytes_sent);
+                continue;
+            }
+            if (bytes_sent < 0 && errno == EINTR) {
+                continue;
+            }
+            if (bytes_sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                connection->closed = true; // The I/O thread closes it
+                notify = true;
+            }
+            break;
+        }
+        if (!connection->closed && sent < frame.size()) {
+            connection->output.append(frame, sent, std::string::npos);
+            notify = true; // First bytes waiting: the I/O thread arms EPOLLOUT
+        }
+    } else {
+        connection->output.append(frame); // Already waiting on EPOLLOUT
+    }
+
+    if (--connection->in_flight == 0 && connection->peer_closed) {
+        notify = true; // Last answer for a half-closed client
+    }
+    if (notify) {
+        wakeIoLoop(connection->loop, connection);
+    }
+}
+
+// Ask a connection's I/O thread to flush (or close) it
+void BankServer::wakeIoLoop(IoLoop* loop, const std::shared_ptr<ClientConnection>& connection) {
+    {
+        std::lock_guard<std::mutex> lock(loop->pending_mutex);
+        loop->pending.push_back(connection);
+    }
+    uint64_t one = 1;
+    if (write(loop->wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        std::cerr << "Failed to wake I/O thread" << std::endl;
+    }
+}
+
+// Send queued replies; arm EPOLLOUT while some remain, close when the connection is done
+void BankServer::flushOutput(IoLoop* loop, ClientConnection* connection) {
+    bool failed = false;
+    bool finished = false;
+    bool want_write = false;
+    {
+        std::lock_guard<std::mutex> lock(connection->write_mutex);
+        size_t sent = 0;
+        while (!connection->closed && sent < connection->output.size()) {
+            ssize_t bytes_sent = send(connection->socket, connection->output.data() + sent,
+                                      connection->output.size() - sent, MSG_NOSIGNAL);
+            if (bytes_sent > 0) {
+                sent += static_cast<size_t>(bytes_sent);
+                continue;
+            }
+            if (bytes_sent < 0 && errno == EINTR) {
+                continue;
+            }
+            if (bytes_sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                failed = true;
+            }
+            break;
+        }
+        connection->output.erase(0, sent);
+
+        failed = failed || connection->closed;
+        finished = connection->peer_closed && connection->in_flight == 0 && connection->output.empty();
+        want_write = !connection->output.empty();
+    }
+
+    if (failed || finished) {
+        closeConnection(loop, connection);
+        return;
+    }
+    if (want_write != connection->want_write) {
+        connection->want_write = want_write;
+        updateEvents(loop, connection);
+    }
+}
+
+// Re-register a connection's epoll interest (EPOLLOUT only while replies are waiting)
+void BankServer::updateEvents(IoLoop* loop, ClientConnection* connection) {
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+    if (connection->want_write) {
+        event.events |= EPOLLOUT;
+    }
+    event.data.ptr = connection;
+
+    if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_MOD, connection->socket, &event) < 0) {
+        std::cerr << "Failed to update epoll events for socket " << connection->socket << std::endl;
+    }
+}
+
+// Unregister a connection; the socket closes when the last worker releases it.
+// The caller must hold its own reference, since this drops the server's.
+void BankServer::closeConnection(IoLoop* loop, ClientConnection* connection) {
+    if (!connection->registered) {
+        return;
+    }
+    connection->registered = false;
+
+    int client_socket = connection->socket;
+    epoll_ctl(loop->epoll_fd, EPOLL_CTL_DEL, client_socket, nullptr);
+
+    {
+        std::lock_guard<std::mutex> lock(connection->write_mutex);
+        connection->closed = true;
+        connection->output.clear();
+    }
+    connection->backlog.clear(); // Queued tasks hold references to the connection
+
+    {
+        std::lock_guard<std::mutex> lock(client_mutex);
+        connections.erase(client_socket);
+    }
+
+    std::cout << "ATM client disconnected from socket " << client_socket << std::endl;
+}
+
+#else
+
+// epoll is Linux-only; other platforms keep using thread-per-client mode
+bool BankServer::startReactor() {
+    std::cerr << "Epoll reactor mode is only available on Linux" << std::endl;
+    return false;
+}
+
+void BankServer::stopReactor() {}
+
+void BankServer::acceptReactorClient(int client_socket) {
+    close(client_socket);
+}
+
+void BankServer::queueReply(const std::shared_ptr<ClientConnection>&, const std::string&, uint32_t) {}
+
+#endif // __linux__
@@ -6,6 +6,11 @@
 #include <fstream>
 #include <sstream>
 #include <future>
+#include <cstdio>
+#include <chrono>
+#include <algorithm>
+#include <unordered_set>
+#include <stdexcept>
 
 // Static member initialization
 std::unique_ptr<BankSystem> BankSystem::instance = nullptr;
@@ -15,8 +20,8 @@ std::mutex BankSystem::instance_mutex;
 BankSystem::BankSystem() 
     : db_handler(DatabaseHandler::getInstance()),
       deadlock_manager(DeadlockStrategy::LOCK_ORDERING),
-      current_user(nullptr),
-      total_users(0), total_accounts(0), total_transactions(0), total_system_balance(0.0) {}
+      balance_writer_stopping(false), current_user(nullptr), initialized(false),
+      total_users(0), total_accounts(0), total_transactions(0), total_system_balance() {}
 
 // Destructor
 BankSystem::~BankSystem() {
@@ -46,7 +51,19 @@ bool BankSystem::initialize() {
         // Initialize caches
         refreshUserCache();
         refreshAccountCache();
+
+        // The journal is authoritative for balances changed since the last checkpoint
+        if (!recoverFromJournal()) {
+            std::cerr << "Failed to recover transaction journal" << std::endl;
+            return false;
+        }
         updateSystemStats();
+
+        balance_writer_stopping = false;
+        if (!balance_writer.joinable()) {
+            balance_writer = std::thread(&BankSystem::balanceWriterLoop, this);
+        }
+        initialized = true;
         
         std::cout << "Banking System initialized successfully" << std::endl;
         return true;
@@ -59,9 +76,31 @@ bool BankSystem::initialize() {
 
 // Shutdown system
 void BankSystem::shutdown() {
-    std::lock_guard<std::mutex> lock(system_mutex);
-    
-    logoutUser();
+    // Only once; the destructor may run after DatabaseHandler is gone
+    if (!initialized.exchange(false)) {
+        return;
+    }
+
+    // Stop the balance writer; it flushes whatever is still pending before exiting
+    {
+        std::lock_guard<std::mutex> lock(dirty_mutex);
+        balance_writer_stopping = true;
+    }
+    dirty_cv.notify_all();
+    if (balance_writer.joinable()) {
+        balance_writer.join();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(scheduler_mutex);
+        transaction_scheduler.reset(); // Joins the workers
+    }
+
+    // Record final balances so the next start replays only what follows
+    checkpointBalances();
+    journal.close();
+
+    logoutUser(); // Takes system_mutex itself
     clearCaches();
     db_handler.disconnect();
     
@@ -129,20 +168,30 @@ void BankSystem::logoutUser() {
     }
 }
 
-// Authenticate user (for ATM server)
-bool BankSystem::authenticateUser(const std::string& email, const std::string& password) {
+// Authenticate user without changing the logged-in user (for ATM server sessions)
+std::shared_ptr<User> BankSystem::authenticate(const std::string& email, const std::string& password) {
     try {
         auto user = db_handler.getUserByEmail(email);
         if (user && Security::verifyPassword(password, user->getPasswordHash())) {
-            std::lock_guard<std::mutex> lock(system_mutex);
-            current_user = user;
-            return true;
+            return user;
         }
-        return false;
+        return nullptr;
     } catch (const std::exception& e) {
         std::cerr << "Authentication error: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+// Authenticate user and make them the logged-in user
+bool BankSystem::authenticateUser(const std::string& email, const std::string& password) {
+    auto user = authenticate(email, password);
+    if (!user) {
         return false;
     }
+
+    std::lock_guard<std::mutex> lock(system_mutex);
+    current_user = user;
+    return true;
 }
 
 // Logout alias for compatibility
@@ -164,17 +213,30 @@ bool BankSystem::isUserLoggedIn() const {
 }
 
 // Create account
-int BankSystem::createAccount(AccountType type, double initial_balance) {
-    if (!isUserLoggedIn()) {
+int BankSystem::createAccount(AccountType type, Money initial_balance) {
+    auto user = getCurrentUser();
+    if (!user) {
         std::cerr << "Please login first" << std::endl;
         return -1;
     }
-    
+
+    return createAccount(user->getUserId(), type, initial_balance);
+}
+
+// Create account for an explicit owner
+int BankSystem::createAccount(int user_id, AccountType type, Money initial_balance) {
     try {
         int account_id = db_handler.getNextAccountId();
-        auto account = std::make_shared<Account>(account_id, current_user->getUserId(), initial_balance, type);
+        if (account_id <= 0) {
+            return -1;
+        }
+        auto account = std::make_shared<Account>(account_id, user_id, initial_balance, type);
         
         if (db_handler.insertAccount(*account)) {
+            // Replay of this account's journal records starts from its opening balance
+            if (!journal.commit(JournalRecord::checkpoint(account_id, initial_balance))) {
+                std::cerr << "Warning: Opening balance of account " << account_id << " was not journaled" << std::endl;
+            }
             addToAccountCache(account);
             updateSystemStats();
             std::cout << "Account created successfully. Account ID: " << account_id << std::endl;
@@ -189,67 +251,56 @@ int BankSystem::createAccount(AccountType type, double initial_balance) {
     }
 }
 
-// Get account with file-based synchronization
+// Get account (read-through: cache hit is a hash lookup, a miss loads and caches it)
 std::shared_ptr<Account> BankSystem::getAccount(int account_id) {
-    std::lock_guard<std::mutex> lock(account_cache_mutex);
-
-    // First try to get from database
-    auto account = db_handler.getAccountById(account_id);
-    if (account) {
-        // Check for synchronized balance from file
-        std::ifstream sync_file("account_" + std::to_string(account_id) + "_balance.sync");
-        if (sync_file.is_open()) {
-            double synced_balance;
-            if (sync_file >> synced_balance) {
-                account->setBalance(synced_balance);
-                std::cout << "Loaded synchronized balance: $" << synced_balance << " for account " << account_id << std::endl;
-            }
-            sync_file.close();
+    {
+        std::shared_lock<std::shared_mutex> lock(account_cache_mutex);
+        auto it = account_cache.find(account_id);
+        if (it != account_cache.end()) {
+            return it->second;
         }
-
-        account_cache[account_id] = account;
-        return account;
     }
 
-    // Fallback to cache if database fails
-    auto it = account_cache.find(account_id);
-    if (it != account_cache.end()) {
-        return it->second;
+    // Load outside the cache lock so a slow query does not block hot readers
+    auto account = loadAccount(account_id);
+    if (!account) {
+        return nullptr;
     }
 
-    return nullptr;
+    return cacheAccount(account);
 }
 
 // Get user accounts
 std::vector<std::shared_ptr<Account>> BankSystem::getUserAccounts() {
-    if (!isUserLoggedIn()) {
+    auto user = getCurrentUser();
+    if (!user) {
         return {};
     }
-    
-    return getUserAccounts(current_user->getUserId());
+
+    return getUserAccounts(user->getUserId());
 }
 
-// Get user accounts by user ID with file synchronization
+// Get user accounts by user ID
 std::vector<std::shared_ptr<Account>> BankSystem::getUserAccounts(int user_id) {
     try {
-        // Always fetch fresh data from database to ensure synchronization
-        auto accounts = db_handler.getAccountsByUserId(user_id);
-
-        // Update cache with fresh data and load synchronized balances
-        std::lock_guard<std::mutex> lock(account_cache_mutex);
-        for (const auto& account : accounts) {
-            // Check for synchronized balance from file
-            std::ifstream sync_file("account_" + std::to_string(account->getAccountId()) + "_balance.sync");
-            if (sync_file.is_open()) {
-                double synced_balance;
-                if (sync_file >> synced_balance) {
-                    account->setBalance(synced_balance);
-                    std::cout << "Loaded synchronized balance: $" << synced_balance << " for account " << account->getAccountId() << std::endl;
+        // The database knows which accounts exist (another terminal may have created one);
+        // balances come from the cache, which is the authoritative copy
+        auto stored_accounts = db_handler.getAccountsByUserId(user_id);
+
+        std::vector<std::shared_ptr<Account>> accounts;
+        accounts.reserve(stored_accounts.size());
+        for (auto& stored : stored_accounts) {
+            {
+                std::shared_lock<std::shared_mutex> lock(account_cache_mutex);
+                auto it = account_cache.find(stored->getAccountId());
+                if (it != account_cache.end()) {
+                    accounts.push_back(it->second);
+                    continue;
                 }
-                sync_file.close();
             }
 
-            account_cache[account->getAccountId()] = account;
+            applySyncedBalance(*stored);
+            accounts.push_back(cacheAccount(stored));
         }
 
         return accounts;
@@ -260,14 +311,68 @@ std::vector<std::shared_ptr<Account>> BankSystem::getUserAccounts(int user_id) {
     }
 }
 
-// Deposit operation
-bool BankSystem::deposit(int account_id, double amount) {
-    if (!isUserLoggedIn()) {
+// Delete account of the logged-in user
+bool BankSystem::deleteAccount(int account_id) {
+    auto user = getCurrentUser();
+    if (!user) {
         std::cerr << "Please login first" << std::endl;
         return false;
     }
 
-    if (!validateAccountOwnership(account_id, current_user->getUserId())) {
+    return deleteAccount(user->getUserId(), account_id);
+}
+
+// Delete (deactivate) an account on behalf of an explicit caller
+bool BankSystem::deleteAccount(int user_id, int account_id) {
+    if (!validateAccountOwnership(account_id, user_id)) {
+        std::cerr << "Account access denied" << std::endl;
+        return false;
+    }
+
+    auto account = getAccount(account_id);
+    if (!account) {
+        std::cerr << "Account not found" << std::endl;
+        return false;
+    }
+
+    // Closing swaps a zero balance for the closed marker, so no deposit can land
+    // between the check and the delete
+    if (!account->close()) {
+        std::cerr << "Account still holds funds. Withdraw or transfer them before closing it." << std::endl;
+        return false;
+    }
+
+    if (!db_handler.deleteAccount(account_id)) {
+        account->setBalance(Money()); // Reopen; it was empty when closed
+        std::cerr << "Failed to delete account " << account_id << std::endl;
+        return false;
+    }
+
+    removeFromAccountCache(account_id);
+    {
+        std::unique_lock<std::shared_mutex> lock(account_owner_mutex);
+        account_owners.erase(account_id);
+    }
+    updateSystemStats();
+
+    std::cout << "Account " << account_id << " closed successfully" << std::endl;
+    return true;
+}
+
+// Deposit operation for the logged-in user
+bool BankSystem::deposit(int account_id, Money amount) {
+    auto user = getCurrentUser();
+    if (!user) {
+        std::cerr << "Please login first" << std::endl;
+        return false;
+    }
+
+    return deposit(user->getUserId(), account_id, amount);
+}
+
+// Deposit operation on behalf of an explicit caller
+bool BankSystem::deposit(int user_id, int account_id, Money amount) {
+    if (!validateAccountOwnership(account_id, user_id)) {
         std::cerr << "Account access denied" << std::endl;
         return false;
     }
@@ -280,6 +385,8 @@ bool BankSystem::deposit(int account_id, double amount) {
 
     // Perform deposit and record transaction
     if (account->deposit(amount) == TransactionStatus::SUCCESS) {
+        markBalanceDirty(account);
+
         // Record transaction in both memory and database
         try {
             auto transaction = Transaction::createDeposit(account_id, amount);
@@ -287,32 +394,23 @@ bool BankSystem::deposit(int account_id, double amount) {
             transaction->setStatus(TransactionStatus::SUCCESS);
 
             // Store in memory transaction cache for immediate access
-            transaction_cache[account_id].push_back(transaction);
+            {
+                std::lock_guard<std::mutex> cache_lock(transaction_cache_mutex);
+                transaction_cache[account_id].push_back(transaction);
+            }
             total_transactions++;
 
-            // Also sync to file for cross-terminal synchronization
-            std::ofstream txn_file("transactions.sync", std::ios::app);
-            if (txn_file.is_open()) {
-                txn_file << transaction->getTransactionId() << "|"
-                         << transaction->getFromAccountId() << "|"
-                         << transaction->getToAccountId() << "|"
-                         << std::fixed << std::setprecision(2) << transaction->getAmount() << "|"
-                         << transaction->getTypeString() << "|"
-                         << transaction->getStatusString() << "|"
-                         << transaction->getDescription() << "|"
-                         << transaction->getTimestamp() << std::endl;
-                txn_file.close();
-                std::cout << "Transaction recorded in synchronized history" << std::endl;
-            } else {
-                std::cout << "Transaction recorded in memory only" << std::endl;
+            // Durable before the caller hears about it
+            if (!journalTransaction(*transaction)) {
+                rollBackUndurable(transaction);
+                std::cerr << "Deposit failed" << std::endl;
+                return false;
             }
         } catch (const std::exception& e) {
             std::cerr << "Warning: Failed to record transaction: " << e.what() << std::endl;
         }
 
-        updateSystemStats();
-        std::cout << "Deposit successful. New balance: $" << std::fixed << std::setprecision(2)
-                  << account->getBalance() << std::endl;
+        std::cout << "Deposit successful. New balance: $" << account->getBalance() << std::endl;
         return true;
     }
 
@@ -320,14 +418,20 @@ bool BankSystem::deposit(int account_id, double amount) {
     return false;
 }
 
-// Withdraw operation
-bool BankSystem::withdraw(int account_id, double amount) {
-    if (!isUserLoggedIn()) {
+// Withdraw operation for the logged-in user
+bool BankSystem::withdraw(int account_id, Money amount) {
+    auto user = getCurrentUser();
+    if (!user) {
         std::cerr << "Please login first" << std::endl;
         return false;
     }
 
-    if (!validateAccountOwnership(account_id, current_user->getUserId())) {
+    return withdraw(user->getUserId(), account_id, amount);
+}
+
+// Withdraw operation on behalf of an explicit caller
+bool BankSystem::withdraw(int user_id, int account_id, Money amount) {
+    if (!validateAccountOwnership(account_id, user_id)) {
         std::cerr << "Account access denied" << std::endl;
         return false;
     }
@@ -340,6 +444,8 @@ bool BankSystem::withdraw(int account_id, double amount) {
 
     // Perform withdrawal and record transaction
     if (account->withdraw(amount) == TransactionStatus::SUCCESS) {
+        markBalanceDirty(account);
+
         // Record transaction in both memory and database
         try {
             auto transaction = Transaction::createWithdrawal(account_id, amount);
@@ -347,32 +453,23 @@ bool BankSystem::withdraw(int account_id, double amount) {
             transaction->setStatus(TransactionStatus::SUCCESS);
 
             // Store in memory transaction cache for immediate access
-            transaction_cache[account_id].push_back(transaction);
+            {
+                std::lock_guard<std::mutex> cache_lock(transaction_cache_mutex);
+                transaction_cache[account_id].push_back(transaction);
+            }
             total_transactions++;
 
-            // Also sync to file for cross-terminal synchronization
-            std::ofstream txn_file("transactions.sync", std::ios::app);
-            if (txn_file.is_open()) {
-                txn_file << transaction->getTransactionId() << "|"
-                         << transaction->getFromAccountId() << "|"
-                         << transaction->getToAccountId() << "|"
-                         << std::fixed << std::setprecision(2) << transaction->getAmount() << "|"
-                         << transaction->getTypeString() << "|"
-                         << transaction->getStatusString() << "|"
-                         << transaction->getDescription() << "|"
-                         << transaction->getTimestamp() << std::endl;
-                txn_file.close();
-                std::cout << "Transaction recorded in synchronized history" << std::endl;
-            } else {
-                std::cout << "Transaction recorded in memory only" << std::endl;
+            // Durable before the caller hears about it
+            if (!journalTransaction(*transaction)) {
+                rollBackUndurable(transaction);
+                std::cerr << "Withdrawal failed" << std::endl;
+                return false;
             }
         } catch (const std::exception& e) {
             std::cerr << "Warning: Failed to record transaction: " << e.what() << std::endl;
         }
 
-        updateSystemStats();
-        std::cout << "Withdrawal successful. New balance: $" << std::fixed << std::setprecision(2)
-                  << account->getBalance() << std::endl;
+        std::cout << "Withdrawal successful. New balance: $" << account->getBalance() << std::endl;
         return true;
     }
 
@@ -380,14 +477,20 @@ bool BankSystem::withdraw(int account_id, double amount) {
     return false;
 }
 
-// Transfer operation with deadlock prevention
-bool BankSystem::transfer(int from_account_id, int to_account_id, double amount) {
-    if (!isUserLoggedIn()) {
+// Transfer operation for the logged-in user
+bool BankSystem::transfer(int from_account_id, int to_account_id, Money amount) {
+    auto user = getCurrentUser();
+    if (!user) {
         std::cerr << "Please login first" << std::endl;
         return false;
     }
 
-    if (!validateAccountOwnership(from_account_id, current_user->getUserId())) {
+    return transfer(user->getUserId(), from_account_id, to_account_id, amount);
+}
+
+// Transfer operation with deadlock prevention on behalf of an explicit caller
+bool BankSystem::transfer(int user_id, int from_account_id, int to_account_id, Money amount) {
+    if (!validateAccountOwnership(from_account_id, user_id)) {
         std::cerr << "Source account access denied" << std::endl;
         return false;
     }
@@ -400,62 +503,69 @@ bool BankSystem::transfer(int from_account_id, int to_account_id, double amount)
         return false;
     }
 
-    // Use deadlock prevention for concurrent transfers
-    std::vector<int> account_ids = {from_account_id, to_account_id};
-    int transaction_id = db_handler.getNextTransactionId();
+    auto transaction = Transaction::createTransfer(from_account_id, to_account_id, amount);
+    transaction->setDescription("Transfer from " + std::to_string(from_account_id) +
+                               " to " + std::to_string(to_account_id));
 
-    std::cout << "Requesting locks for accounts " << from_account_id << " and " << to_account_id
-              << " (Transaction ID: " << transaction_id << ")" << std::endl;
+    TransactionStatus result;
+    if (deadlock_manager.getStrategy() == DeadlockStrategy::OPTIMISTIC) {
+        result = transferOptimistic(from_account, to_account, amount);
+    } else {
+        // Use deadlock prevention for concurrent transfers
+        std::vector<int> account_ids = {from_account_id, to_account_id};
+        int transaction_id = db_handler.getNextTransactionId();
+        if (transaction_id <= 0) {
+            std::cerr << "Could not allocate a transaction ID" << std::endl;
+            return false;
+        }
 
-    if (!deadlock_manager.requestLocks(account_ids, transaction_id)) {
-        std::cerr << "Failed to acquire locks - potential deadlock prevented" << std::endl;
-        return false;
-    }
+        std::cout << "Requesting locks for accounts " << from_account_id << " and " << to_account_id
+                  << " (Transaction ID: " << transaction_id << ")" << std::endl;
 
-    std::cout << "Locks acquired successfully, proceeding with transfer..." << std::endl;
+        TransactionHandle lock_transaction = deadlock_manager.beginTransaction(transaction_id);
+        if (!deadlock_manager.requestLocks(lock_transaction, account_ids)) {
+            deadlock_manager.endTransaction(lock_transaction);
+            std::cerr << "Failed to acquire locks - potential deadlock prevented" << std::endl;
+            return false;
+        }
 
-    auto transaction = Transaction::createTransfer(from_account_id, to_account_id, amount);
-    transaction->setDescription("Transfer from " + std::to_string(from_account_id) +
-                               " to " + std::to_string(to_account_id));
+        std::cout << "Locks acquired successfully, proceeding with transfer..." << std::endl;
 
-    TransactionStatus result = from_account->transfer(to_account, amount);
+        result = from_account->transfer(to_account, amount);
 
-    // Release locks after operation
-    deadlock_manager.releaseLocks(account_ids);
-    std::cout << "Locks released for accounts " << from_account_id << " and " << to_account_id << std::endl;
+        // Release locks after operation
+        deadlock_manager.releaseLocks(lock_transaction, account_ids);
+        deadlock_manager.endTransaction(lock_transaction);
+        std::cout << "Locks released for accounts " << from_account_id << " and " << to_account_id << std::endl;
+    }
 
     if (result == TransactionStatus::SUCCESS) {
+        markBalanceDirty(from_account);
+        markBalanceDirty(to_account);
+
         // Record transaction in both memory and database
         try {
             transaction->setStatus(TransactionStatus::SUCCESS);
 
             // Store in memory transaction cache for both accounts
-            transaction_cache[from_account_id].push_back(transaction);
-            transaction_cache[to_account_id].push_back(transaction);
+            {
+                std::lock_guard<std::mutex> cache_lock(transaction_cache_mutex);
+                transaction_cache[from_account_id].push_back(transaction);
+                transaction_cache[to_account_id].push_back(transaction);
+            }
             total_transactions++;
 
-            // Also sync to file for cross-terminal synchronization
-            std::ofstream txn_file("transactions.sync", std::ios::app);
-            if (txn_file.is_open()) {
-                txn_file << transaction->getTransactionId() << "|"
-                         << transaction->getFromAccountId() << "|"
-                         << transaction->getToAccountId() << "|"
-                         << std::fixed << std::setprecision(2) << transaction->getAmount() << "|"
-                         << transaction->getTypeString() << "|"
-                         << transaction->getStatusString() << "|"
-                         << transaction->getDescription() << "|"
-                         << transaction->getTimestamp() << std::endl;
-                txn_file.close();
-                std::cout << "Transfer transaction recorded in synchronized history" << std::endl;
-            } else {
-                std::cout << "Transfer transaction recorded in memory only" << std::endl;
+            // Durable before the caller hears about it
+            if (!journalTransaction(*transaction)) {
+                rollBackUndurable(transaction);
+                std::cerr << "Transfer failed" << std::endl;
+                return false;
             }
         } catch (const std::exception& e) {
             std::cerr << "Warning: Failed to record transaction: " << e.what() << std::endl;
         }
 
-        updateSystemStats();
-        std::cout << "Transfer successful. Amount: $" << std::fixed << std::setprecision(2) << amount << std::endl;
+        std::cout << "Transfer successful. Amount: $" << amount << std::endl;
         return true;
     }
 
@@ -463,95 +573,355 @@ bool BankSystem::transfer(int from_account_id, int to_account_id, double amount)
     return false;
 }
 
-// Get account transactions with file synchronization
+// Optimistic transfer: repeat the read-validate-commit cycle while concurrent
+// updates to either account keep invalidating it
+TransactionStatus BankSystem::transferOptimistic(const std::shared_ptr<Account>& from_account,
+                                                 const std::shared_ptr<Account>& to_account, Money amount) {
+    for (int attempt = 0; attempt <= BankingConstants::OPTIMISTIC_TRANSFER_RETRIES; attempt++) {
+        TransactionStatus result = from_account->transferOptimistic(to_account, amount);
+        if (result == TransactionStatus::SUCCESS) {
+            deadlock_manager.recordOptimisticOutcome(true);
+        }
+        if (result != TransactionStatus::PENDING) {
+            return result;
+        }
+
+        deadlock_manager.recordOptimisticConflict();
+        std::this_thread::yield();
+    }
+
+    deadlock_manager.recordOptimisticOutcome(false);
+    std::cerr << "Transfer kept conflicting with concurrent updates" << std::endl;
+    return TransactionStatus::FAILED;
+}
+
+// Execute a batch of transactions in parallel. Each transaction waits only for the
+// earlier ones in the batch that touch one of its accounts, so transactions on
+// disjoint accounts run side by side while conflicting ones keep their input
+// order. This is a system-level path: no ownership checks are made, callers
+// authorize the batch. Returns once every successful transaction is durable.
+std::vector<TransactionStatus> BankSystem::processTransactionsConcurrently(
+    const std::vector<std::shared_ptr<Transaction>>& transactions) {
+    const size_t count = transactions.size();
+    std::vector<TransactionStatus> statuses(count, TransactionStatus::FAILED);
+    if (count == 0) {
+        return statuses;
+    }
+
+    // Dependency graph: an edge from the previous transaction on each account
+    struct BatchNode {
+        std::atomic<size_t> waiting{0};
+        std::vector<size_t> successors;
+    };
+    std::vector<BatchNode> nodes(count);
+    std::unordered_map<int, size_t> last_on_account;
+    for (size_t i = 0; i < count; i++) {
+        if (!transactions[i]) {
+            continue;
+        }
+
+        size_t first_predecessor = count;
+        for (int account_id : {transactions[i]->getFromAccountId(), transactions[i]->getToAccountId()}) {
+            if (account_id <= 0) {
+                continue;
+            }
+            auto it = last_on_account.find(account_id);
+            if (it != last_on_account.end() && it->second != i && it->second != first_predecessor) {
+                nodes[it->second].successors.push_back(i);
+                nodes[i].waiting++;
+                first_predecessor = it->second;
+            }
+            last_on_account[account_id] = i;
+        }
+    }
+
+    std::vector<uint64_t> lsns(count, 0);
+    std::atomic<size_t> remaining(count);
+    std::mutex done_mutex;
+    std::condition_variable done_cv;
+    bool batch_done = false;
+    WorkStealingScheduler& scheduler = getTransactionScheduler();
+
+    // Run one transaction, then release the ones that were waiting only on it.
+    // A transaction that throws fails alone; its successors and the count of
+    // remaining work still move on, or the caller would wait forever.
+    std::function<void(size_t)> run = [&](size_t i) {
+        if (transactions[i]) {
+            try {
+                statuses[i] = executeBatchTransaction(transactions[i], lsns[i]);
+            } catch (const std::exception& e) {
+                std::cerr << "Batch transaction error: " << e.what() << std::endl;
+                transactions[i]->setStatus(TransactionStatus::FAILED);
+                statuses[i] = TransactionStatus::FAILED;
+            }
+        }
+        for (size_t successor : nodes[i].successors) {
+            if (--nodes[successor].waiting == 0 && !scheduler.submit([&run, successor]() { run(successor); })) {
+                run(successor); // Scheduler is shutting down; finish the chain here
+            }
+        }
+        if (--remaining == 0) {
+            std::lock_guard<std::mutex> lock(done_mutex);
+            batch_done = true;
+            done_cv.notify_all(); // Under the lock: the caller's stack is gone once it wakes
+        }
+    };
+
+    for (size_t i = 0; i < count; i++) {
+        if (nodes[i].waiting == 0 && !scheduler.submit([&run, i]() { run(i); })) {
+            run(i);
+        }
+    }
+    {
+        std::unique_lock<std::mutex> lock(done_mutex);
+        done_cv.wait(lock, [&batch_done]() { return batch_done; });
+    }
+
+    // One journal flush usually covers the whole batch; anything whose record was
+    // lost is undone, newest first so reversals see the balances they produced
+    for (size_t i = count; i-- > 0;) {
+        if (statuses[i] == TransactionStatus::SUCCESS && !journal.waitForDurable(lsns[i])) {
+            rollBackUndurable(transactions[i]);
+            statuses[i] = TransactionStatus::FAILED;
+        }
+    }
+
+    size_t succeeded = std::count(statuses.begin(), statuses.end(), TransactionStatus::SUCCESS);
+    std::cout << "Processed " << count << " transaction(s) concurrently: " << succeeded << " succeeded, "
+              << (count - succeeded) << " failed" << std::endl;
+    return statuses;
+}
+
+// Scheduler for transaction batches, started on first use
+WorkStealingScheduler& BankSystem::getTransactionScheduler() {
+    std::lock_guard<std::mutex> lock(scheduler_mutex);
+    if (!transaction_scheduler) {
+        transaction_scheduler = std::make_unique<WorkStealingScheduler>();
+    }
+    return *transaction_scheduler;
+}
+
+// Apply one batch transaction and queue its journal record (lsn is left 0 on failure)
+TransactionStatus BankSystem::executeBatchTransaction(const std::shared_ptr<Transaction>& batch_transaction,
+                                                     uint64_t& lsn) {
+    Transaction& transaction = *batch_transaction;
+    if (!transaction.isValid()) {
+        transaction.setStatus(TransactionStatus::FAILED);
+        return TransactionStatus::FAILED;
+    }
+
+    int from_account_id = transaction.getFromAccountId();
+    int to_account_id = transaction.getToAccountId();
+    auto from_account = from_account_id > 0 ? getAccount(from_account_id) : nullptr;
+    auto to_account = to_account_id > 0 ? getAccount(to_account_id) : nullptr;
+
+    TransactionStatus result = TransactionStatus::FAILED;
+    switch (transaction.getType()) {
+        case TransactionType::DEPOSIT:
+            if (to_account) {
+                result = to_account->deposit(transaction.getAmount());
+            }
+            break;
+        case TransactionType::WITHDRAWAL:
+            if (from_account) {
+                result = from_account->withdraw(transaction.getAmount());
+            }
+            break;
+        case TransactionType::TRANSFER:
+            if (from_account && to_account) {
+                result = from_account->transfer(to_account, transaction.getAmount());
+            }
+            break;
+        case TransactionType::INTEREST:
+            if (to_account && to_account->postInterest(transaction.getAmount())) {
+                result = TransactionStatus::SUCCESS;
+            }
+            break;
+    }
+
+    transaction.setStatus(result);
+    if (result != TransactionStatus::SUCCESS) {
+        return result;
+    }
+
+    if (from_account) {
+        markBalanceDirty(from_account);
+    }
+    if (to_account) {
+        markBalanceDirty(to_account);
+    }
+
+    if (transaction.getTransactionId() <= 0) {
+        transaction.setTransactionId(db_handler.getNextTransactionId());
+    }
+    {
+        std::lock_guard<std::mutex> cache_lock(transaction_cache_mutex);
+        if (from_account_id > 0) {
+            transaction_cache[from_account_id].push_back(batch_transaction);
+        }
+        if (to_account_id > 0) {
+            transaction_cache[to_account_id].push_back(batch_transaction);
+        }
+    }
+    total_transactions++;
+
+    lsn = journal.append(JournalRecord::fromTransaction(transaction));
+    return result;
+}
+
+// Get account transactions from the journal (indexed by account)
 std::vector<std::shared_ptr<Transaction>> BankSystem::getAccountTransactions(int account_id) {
-    if (!isUserLoggedIn()) {
+    auto user = getCurrentUser();
+    if (!user) {
         std::cerr << "Please login first" << std::endl;
         return {};
     }
 
-    if (!validateAccountOwnership(account_id, current_user->getUserId())) {
+    return getAccountTransactions(user->getUserId(), account_id);
+}
+
+// Get account transactions on behalf of an explicit caller
+std::vector<std::shared_ptr<Transaction>> BankSystem::getAccountTransactions(int user_id, int account_id) {
+    if (!validateAccountOwnership(account_id, user_id)) {
         std::cerr << "Account access denied" << std::endl;
         return {};
     }
 
     std::vector<std::shared_ptr<Transaction>> account_transactions;
 
-    // Load transactions from synchronized file
-    std::ifstream txn_file("transactions.sync");
-    if (txn_file.is_open()) {
-        std::string line;
-        while (std::getline(txn_file, line)) {
-            std::istringstream iss(line);
-            std::string token;
-            std::vector<std::string> tokens;
-
-            while (std::getline(iss, token, '|')) {
-                tokens.push_back(token);
-            }
+    std::vector<JournalRecord> records;
+    if (!journal.readAccountRecords(account_id, records)) {
+        std::cerr << "Failed to read transaction journal" << std::endl;
+        return account_transactions;
+    }
 
-            if (tokens.size() >= 7) {
-                int txn_id = std::stoi(tokens[0]);
-                int from_account = (tokens[1] == "0") ? 0 : std::stoi(tokens[1]);
-                int to_account = (tokens[2] == "0") ? 0 : std::stoi(tokens[2]);
-                double amount = std::stod(tokens[3]);
-
-                // Check if this transaction involves the requested account
-                if (from_account == account_id || to_account == account_id) {
-                    TransactionType type = TransactionType::DEPOSIT;
-                    if (tokens[4] == "WITHDRAWAL") type = TransactionType::WITHDRAWAL;
-                    else if (tokens[4] == "TRANSFER") type = TransactionType::TRANSFER;
-                    else if (tokens[4] == "INTEREST") type = TransactionType::INTEREST;
-
-                    TransactionStatus status = TransactionStatus::SUCCESS;
-                    if (tokens[5] == "FAILED") status = TransactionStatus::FAILED;
-                    else if (tokens[5] == "PENDING") status = TransactionStatus::PENDING;
-
-                    auto transaction = std::make_shared<Transaction>(txn_id, from_account, to_account, amount, type, status);
-                    transaction->setDescription(tokens[6]);
-                    account_transactions.push_back(transaction);
-                }
+    account_transactions.reserve(records.size());
+    for (const auto& record : records) {
+        account_transactions.push_back(record.toTransaction());
+    }
+
+    return account_transactions;
+}
+
+// Get one page of account history, newest first (see TransactionPage)
+TransactionPage BankSystem::getAccountTransactionPage(int account_id, int limit, const std::string& cursor) {
+    auto user = getCurrentUser();
+    if (!user) {
+        std::cerr << "Please login first" << std::endl;
+        return {};
+    }
+
+    return getAccountTransactionPage(user->getUserId(), account_id, limit, cursor);
+}
+
+// Get one page of account history on behalf of an explicit caller. Pages come from
+// the journal's per-account index; the cursor is a position in that index.
+TransactionPage BankSystem::getAccountTransactionPage(int user_id, int account_id, int limit,
+                                                      const std::string& cursor) {
+    TransactionPage page;
+    if (!validateAccountOwnership(account_id, user_id)) {
+        std::cerr << "Account access denied" << std::endl;
+        return page;
+    }
+    if (limit <= 0) {
+        return page;
+    }
+
+    uint64_t before = 0;
+    if (!cursor.empty()) {
+        try {
+            size_t parsed = 0;
+            before = std::stoull(cursor, &parsed);
+            if (parsed != cursor.size() || before == 0) {
+                throw std::invalid_argument(cursor);
             }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid transaction history cursor" << std::endl;
+            return page;
         }
-        txn_file.close();
     }
 
-    return account_transactions;
+    std::vector<JournalRecord> records;
+    uint64_t next_before = 0;
+    if (!journal.readAccountPage(account_id, static_cast<size_t>(limit), before, records, next_before)) {
+        std::cerr << "Failed to read transaction journal" << std::endl;
+        return page;
+    }
+
+    page.transactions.reserve(records.size());
+    for (const auto& record : records) {
+        page.transactions.push_back(record.toTransaction());
+    }
+    if (next_before != 0) {
+        page.next_cursor = std::to_string(next_before);
+    }
+    return page;
 }
 
 // Update system statistics
 void BankSystem::updateSystemStats() {
     // This would typically query the database for current stats
     // For now, we'll implement a simplified version
-    total_system_balance = 0.0;
-    
-    std::lock_guard<std::mutex> lock(account_cache_mutex);
+    Money balance_sum;
+
+    std::shared_lock<std::shared_mutex> lock(account_cache_mutex);
     for (const auto& [id, account] : account_cache) {
-        total_system_balance += account->getBalance();
+        balance_sum += account->getBalance();
     }
+    total_system_balance = balance_sum;
 }
 
 // Display system statistics
 void BankSystem::displaySystemStats() const {
+    // Balances are summed here rather than on every deposit and withdrawal
+    const_cast<BankSystem*>(this)->updateSystemStats();
+
     std::lock_guard<std::mutex> lock(system_mutex);
     
     std::cout << "=== Banking System Statistics ===" << std::endl;
     std::cout << "Total Users: " << total_users << std::endl;
     std::cout << "Total Accounts: " << total_accounts << std::endl;
     std::cout << "Total Transactions: " << total_transactions << std::endl;
-    std::cout << "Total System Balance: $" << std::fixed << std::setprecision(2) << total_system_balance << std::endl;
+    std::cout << "Total System Balance: $" << total_system_balance << std::endl;
+    std::cout << "Statement Cache Hits: " << db_handler.getStatementCacheHits()
+              << " (misses: " << db_handler.getStatementCacheMisses() << ")" << std::endl;
     std::cout << "=================================" << std::endl;
 }
 
-// Validate account ownership
-bool BankSystem::validateAccountOwnership(int account_id, int user_id) const {
-    auto account = db_handler.getAccountById(account_id);
-    return account && account->getUserId() == user_id;
+// Validate account ownership (memory lookup; an unknown account is loaded once through the cache)
+bool BankSystem::validateAccountOwnership(int account_id, int user_id) {
+    int owner_id = 0;
+    if (!lookupAccountOwner(account_id, owner_id)) {
+        auto account = getAccount(account_id); // Read-through also records the owner
+        if (!account) {
+            return false;
+        }
+        owner_id = account->getUserId();
+    }
+    return owner_id == user_id;
 }
 
 // Check if account exists
-bool BankSystem::accountExists(int account_id) const {
-    return db_handler.getAccountById(account_id) != nullptr;
+bool BankSystem::accountExists(int account_id) {
+    int owner_id = 0;
+    return lookupAccountOwner(account_id, owner_id) || getAccount(account_id) != nullptr;
+}
+
+// Look up an account's owner in the ownership index
+bool BankSystem::lookupAccountOwner(int account_id, int& owner_id) const {
+    std::shared_lock<std::shared_mutex> lock(account_owner_mutex);
+    auto it = account_owners.find(account_id);
+    if (it == account_owners.end()) {
+        return false;
+    }
+    owner_id = it->second;
+    return true;
+}
+
+// Record an account's owner in the ownership index
+void BankSystem::recordAccountOwner(int account_id, int owner_id) {
+    std::unique_lock<std::shared_mutex> lock(account_owner_mutex);
+    account_owners[account_id] = owner_id;
 }
 
 // Add to user cache
@@ -562,10 +932,323 @@ void BankSystem::addToUserCache(std::shared_ptr<User> user) {
 
 // Add to account cache
 void BankSystem::addToAccountCache(std::shared_ptr<Account> account) {
-    std::lock_guard<std::mutex> lock(account_cache_mutex);
+    recordAccountOwner(account->getAccountId(), account->getUserId());
+
+    std::unique_lock<std::shared_mutex> lock(account_cache_mutex);
     account_cache[account->getAccountId()] = account;
 }
 
+// Remove from account cache
+void BankSystem::removeFromAccountCache(int account_id) {
+    std::unique_lock<std::shared_mutex> lock(account_cache_mutex);
+    account_cache.erase(account_id);
+}
+
+// Cache an account unless another thread got there first; returns the cached instance
+// so every caller shares one Account object (and one mutex) per account id
+std::shared_ptr<Account> BankSystem::cacheAccount(std::shared_ptr<Account> account) {
+    recordAccountOwner(account->getAccountId(), account->getUserId());
+
+    std::unique_lock<std::shared_mutex> lock(account_cache_mutex);
+    auto result = account_cache.emplace(account->getAccountId(), account);
+    return result.first->second;
+}
+
+// Load an account from storage, reconciling with the legacy balance sync file
+std::shared_ptr<Account> BankSystem::loadAccount(int account_id) {
+    auto account = db_handler.getAccountById(account_id);
+    if (account) {
+        applySyncedBalance(*account);
+    }
+    return account;
+}
+
+// The per-account sync file may hold a newer balance than the database (e.g. from another terminal)
+void BankSystem::applySyncedBalance(Account& account) {
+    std::ifstream sync_file("account_" + std::to_string(account.getAccountId()) + "_balance.sync");
+    if (!sync_file.is_open()) {
+        return;
+    }
+
+    std::string balance_text;
+    Money synced_balance;
+    if (sync_file >> balance_text && Money::parse(balance_text, synced_balance)) {
+        account.setBalance(synced_balance);
+        std::cout << "Loaded synchronized balance: $" << synced_balance << " for account " << account.getAccountId() << std::endl;
+    }
+}
+
+// Queue an account for the balance writer; repeated updates before the next flush coalesce
+void BankSystem::markBalanceDirty(std::shared_ptr<Account> account) {
+    {
+        std::lock_guard<std::mutex> lock(dirty_mutex);
+        dirty_accounts[account->getAccountId()] = account;
+    }
+    dirty_cv.notify_one();
+}
+
+// Write the latest balance of every dirty account to its sync file and the database.
+// All updates are queued before waiting on any, so the database writer commits them together.
+void BankSystem::flushDirtyBalances() {
+    std::unordered_map<int, std::shared_ptr<Account>> pending;
+    {
+        std::lock_guard<std::mutex> lock(dirty_mutex);
+        pending.swap(dirty_accounts);
+    }
+
+    std::lock_guard<std::mutex> write_lock(balance_write_mutex);
+    std::vector<std::pair<int, std::future<bool>>> updates;
+    updates.reserve(pending.size());
+    for (const auto& [account_id, account] : pending) {
+        if (account->isClosed()) {
+            continue; // deleteAccount already deactivated it
+        }
+
+        writeSyncFile(*account);
+        updates.emplace_back(account_id, db_handler.updateAccountAsync(*account));
+    }
+
+    for (auto& [account_id, update] : updates) {
+        if (!update.get()) {
+            std::cerr << "Warning: Failed to persist balance for account " << account_id << std::endl;
+        }
+    }
+}
+
+// Store a balance in its sync file
+void BankSystem::writeSyncFile(const Account& account) {
+    std::ofstream sync_file("account_" + std::to_string(account.getAccountId()) + "_balance.sync");
+    if (sync_file.is_open()) {
+        sync_file << account.getBalance() << std::endl;
+    }
+}
+
+// Balance writer thread main loop
+void BankSystem::balanceWriterLoop() {
+    std::unique_lock<std::mutex> lock(dirty_mutex);
+    while (true) {
+        dirty_cv.wait(lock, [this]() { return balance_writer_stopping || !dirty_accounts.empty(); });
+        bool stopping = balance_writer_stopping;
+
+        lock.unlock();
+        flushDirtyBalances();
+        lock.lock();
+
+        if (stopping && dirty_accounts.empty()) {
+            break;
+        }
+    }
+}
+
+// Journal a committed transaction and wait until it is on disk
+bool BankSystem::journalTransaction(const Transaction& transaction) {
+    if (!journal.commit(JournalRecord::fromTransaction(transaction))) {
+        std::cerr << "Transaction " << transaction.getTransactionId() << " could not be made durable" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Undo a transaction whose journal record never became durable. Recovery will not
+// replay it, so it must not stay in the balances or the history either.
+void BankSystem::rollBackUndurable(const std::shared_ptr<Transaction>& transaction) {
+    int from_account_id = transaction->getFromAccountId();
+    int to_account_id = transaction->getToAccountId();
+    auto from_account = from_account_id > 0 ? getAccount(from_account_id) : nullptr;
+    auto to_account = to_account_id > 0 ? getAccount(to_account_id) : nullptr;
+    Money amount = transaction->getAmount();
+
+    bool reversed = false;
+    switch (transaction->getType()) {
+        case TransactionType::DEPOSIT:
+        case TransactionType::INTEREST:
+            reversed = to_account && to_account->withdraw(amount) == TransactionStatus::SUCCESS;
+            break;
+        case TransactionType::WITHDRAWAL:
+            reversed = from_account && from_account->deposit(amount) == TransactionStatus::SUCCESS;
+            break;
+        case TransactionType::TRANSFER:
+            reversed = from_account && to_account &&
+                       to_account->transfer(from_account, amount) == TransactionStatus::SUCCESS;
+            break;
+    }
+    if (!reversed) {
+        std::cerr << "Transaction " << transaction->getTransactionId()
+                  << " could not be reversed; balances are ahead of the journal" << std::endl;
+    }
+
+    if (from_account) {
+        markBalanceDirty(from_account);
+    }
+    if (to_account) {
+        markBalanceDirty(to_account);
+    }
+    {
+        std::lock_guard<std::mutex> cache_lock(transaction_cache_mutex);
+        for (int account_id : {from_account_id, to_account_id}) {
+            auto it = transaction_cache.find(account_id);
+            if (it != transaction_cache.end()) {
+                auto& cached = it->second;
+                cached.erase(std::remove(cached.begin(), cached.end(), transaction), cached.end());
+            }
+        }
+    }
+    total_transactions--;
+    transaction->setStatus(TransactionStatus::FAILED);
+}
+
+// Open the journal and rebuild balances from it: each account's latest checkpoint
+// plus every committed transaction after it. Accounts the journal has never seen
+// get a checkpoint of their current balance.
+bool BankSystem::recoverFromJournal() {
+    std::vector<JournalRecord> records;
+    if (!journal.open(records)) {
+        return false;
+    }
+
+    std::unordered_map<int, Money> balances;
+    for (const auto& record : records) {
+        if (record.kind == JournalRecord::Kind::CHECKPOINT) {
+            balances[record.to_account_id] = record.amount;
+            continue;
+        }
+        if (record.kind != JournalRecord::Kind::TRANSACTION || record.status != TransactionStatus::SUCCESS) {
+            continue;
+        }
+
+        auto from = balances.find(record.from_account_id);
+        if (from != balances.end()) {
+            from->second -= record.amount;
+        }
+        auto to = balances.find(record.to_account_id);
+        if (to != balances.end()) {
+            to->second += record.amount;
+        }
+    }
+
+    std::vector<std::pair<int, Money>> recovered;
+    for (const auto& [account_id, balance] : balances) {
+        auto account = getAccount(account_id);
+        if (!account || account->getBalance() == balance) {
+            continue; // Closed since, or storage already caught up
+        }
+
+        account->setBalance(balance);
+        writeSyncFile(*account);
+        recovered.emplace_back(account_id, balance);
+        std::cout << "Recovered balance $" << balance << " for account " << account_id << " from journal" << std::endl;
+    }
+    if (!db_handler.updateAccountBalances(recovered)) {
+        std::cerr << "Warning: Failed to persist " << recovered.size() << " recovered balance(s)" << std::endl;
+    }
+
+    importLegacyTransactions();
+
+    std::vector<std::shared_ptr<Account>> unjournaled;
+    {
+        std::shared_lock<std::shared_mutex> lock(account_cache_mutex);
+        for (const auto& [account_id, account] : account_cache) {
+            if (balances.find(account_id) == balances.end()) {
+                unjournaled.push_back(account);
+            }
+        }
+    }
+    for (const auto& account : unjournaled) {
+        journal.append(JournalRecord::checkpoint(account->getAccountId(), account->getBalance()));
+    }
+
+    total_transactions = 0;
+    for (const auto& record : records) {
+        if (record.kind != JournalRecord::Kind::CHECKPOINT) {
+            total_transactions++;
+        }
+    }
+    return true;
+}
+
+// Move history from the old pipe-separated transactions.sync file into the journal (once)
+void BankSystem::importLegacyTransactions() {
+    std::ifstream txn_file("transactions.sync");
+    if (!txn_file.is_open()) {
+        return;
+    }
+
+    size_t imported = 0;
+    std::string line;
+    while (std::getline(txn_file, line)) {
+        std::istringstream iss(line);
+        std::string token;
+        std::vector<std::string> tokens;
+
+        while (std::getline(iss, token, '|')) {
+            tokens.push_back(token);
+        }
+
+        Money amount;
+        if (tokens.size() < 7 || !Money::parse(tokens[3], amount)) {
+            continue;
+        }
+
+        try {
+            TransactionType type = TransactionType::DEPOSIT;
+            if (tokens[4] == "WITHDRAWAL") type = TransactionType::WITHDRAWAL;
+            else if (tokens[4] == "TRANSFER") type = TransactionType::TRANSFER;
+            else if (tokens[4] == "INTEREST") type = TransactionType::INTEREST;
+
+            TransactionStatus status = TransactionStatus::SUCCESS;
+            if (tokens[5] == "FAILED") status = TransactionStatus::FAILED;
+            else if (tokens[5] == "PENDING") status = TransactionStatus::PENDING;
+
+            Transaction transaction(std::stoi(tokens[0]), std::stoi(tokens[1]), std::stoi(tokens[2]),
+                                    amount, type, status);
+            transaction.setDescription(tokens[6]);
+            if (tokens.size() >= 8) {
+                transaction.setTimestamp(tokens[7]);
+            }
+
+            // History only: the balances these produced are already in storage
+            journal.append(JournalRecord::fromTransaction(transaction, JournalRecord::Kind::IMPORTED));
+            imported++;
+        } catch (const std::exception& e) {
+            std::cerr << "Skipping malformed legacy transaction: " << line << std::endl;
+        }
+    }
+    txn_file.close();
+
+    if (std::rename("transactions.sync", "transactions.sync.imported") == 0) {
+        std::cout << "Imported " << imported << " legacy transaction(s) into the journal" << std::endl;
+    } else {
+        std::cerr << "Warning: Could not rename transactions.sync after import" << std::endl;
+    }
+}
+
+// Journal the current balance of every cached account
+void BankSystem::checkpointBalances() {
+    std::vector<std::shared_ptr<Account>> accounts;
+    {
+        std::shared_lock<std::shared_mutex> lock(account_cache_mutex);
+        for (const auto& [account_id, account] : account_cache) {
+            accounts.push_back(account);
+        }
+    }
+
+    uint64_t last_lsn = 0;
+    for (const auto& account : accounts) {
+        if (!account->isClosed()) {
+            last_lsn = journal.append(JournalRecord::checkpoint(account->getAccountId(), account->getBalance()));
+        }
+    }
+    if (last_lsn != 0) {
+        journal.waitForDurable(last_lsn);
+    }
+}
+
+// Drop an account from the cache so the next read reloads it from storage
+// (use after another process has changed the account)
+void BankSystem::invalidateAccount(int account_id) {
+    removeFromAccountCache(account_id);
+}
+
 // Refresh user cache
 void BankSystem::refreshUserCache() {
     std::lock_guard<std::mutex> lock(user_cache_mutex);
@@ -579,9 +1262,21 @@ void BankSystem::refreshUserCache() {
 
 // Refresh account cache
 void BankSystem::refreshAccountCache() {
-    std::lock_guard<std::mutex> lock(account_cache_mutex);
-    account_cache.clear();
     auto accounts = db_handler.getAllAccounts();
+    for (auto& account : accounts) {
+        applySyncedBalance(*account);
+    }
+
+    {
+        std::unique_lock<std::shared_mutex> owner_lock(account_owner_mutex);
+        account_owners.clear();
+        for (const auto& account : accounts) {
+            account_owners[account->getAccountId()] = account->getUserId();
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(account_cache_mutex);
+    account_cache.clear();
     for (auto account : accounts) {
         account_cache[account->getAccountId()] = account;
     }
@@ -591,10 +1286,12 @@ void BankSystem::refreshAccountCache() {
 // Clear caches
 void BankSystem::clearCaches() {
     std::lock_guard<std::mutex> user_lock(user_cache_mutex);
-    std::lock_guard<std::mutex> account_lock(account_cache_mutex);
+    std::unique_lock<std::shared_mutex> account_lock(account_cache_mutex);
+    std::unique_lock<std::shared_mutex> owner_lock(account_owner_mutex);
 
     user_cache.clear();
     account_cache.clear();
+    account_owners.clear();
 }
 
 // Display all users (admin function)
@@ -628,7 +1325,236 @@ void BankSystem::displayAllAccounts() const {
         std::cout << "Account ID: " << account->getAccountId()
                   << " | User ID: " << account->getUserId()
                   << " | Type: " << account->getAccountTypeString()
-                  << " | Balance: $" << std::fixed << std::setprecision(2) << account->getBalance()
+                  << " | Balance: $" << account->getBalance()
                   << std::endl;
     }
 }
+
+// Post one month of interest at annual_rate to every open savings account.
+// Balances are copied into a columnar snapshot, interest is computed in parallel
+// chunks, and each chunk is journaled, credited and committed to the database
+// as one batch. A run belongs to the current month: rerunning it after a crash
+// skips the accounts whose INTEREST records already reached the journal, and
+// rerunning a finished month does nothing.
+void BankSystem::applyInterestToAllSavingsAccounts(double annual_rate) {
+    if (annual_rate < 0.0 || annual_rate > 1.0) {
+        std::cerr << "Invalid interest rate: " << annual_rate << std::endl;
+        return;
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+    std::string period = InterestEngine::currentPeriod();
+
+    double run_rate = annual_rate;
+    bool completed = false;
+    bool resumed = false;
+    if (!db_handler.startInterestRun(period, annual_rate, run_rate, completed, resumed)) {
+        std::cerr << "Failed to start interest run for " << period << std::endl;
+        return;
+    }
+    if (completed) {
+        std::cout << "Interest for " << period << " has already been posted" << std::endl;
+        return;
+    }
+    if (run_rate != annual_rate) {
+        std::cout << "Resuming interest run for " << period << " at its original rate " << run_rate << std::endl;
+    }
+
+    // Accounts this period already credited before an interruption; a fresh run has none,
+    // so only a resumed run pays for reading the journal
+    std::unordered_set<int> already_posted;
+    if (resumed) {
+        std::string description = InterestEngine::describePeriod(period);
+        std::vector<JournalRecord> records;
+        if (!journal.readAll(records)) {
+            std::cerr << "Failed to read the journal; interest run aborted" << std::endl;
+            return;
+        }
+        for (const auto& record : records) {
+            if (record.kind == JournalRecord::Kind::TRANSACTION && record.type == TransactionType::INTEREST &&
+                record.description == description) {
+                already_posted.insert(record.to_account_id);
+            }
+        }
+    }
+
+    InterestSnapshot snapshot;
+    {
+        std::shared_lock<std::shared_mutex> lock(account_cache_mutex);
+        for (const auto& [account_id, account] : account_cache) {
+            if (account->getAccountType() == AccountType::SAVINGS && !account->isClosed() &&
+                already_posted.find(account_id) == already_posted.end()) {
+                snapshot.add(account);
+            }
+        }
+    }
+    snapshot.interest.resize(snapshot.size());
+
+    const size_t chunk_size = static_cast<size_t>(BankingConstants::INTEREST_CHUNK_SIZE);
+    const size_t chunk_count = (snapshot.size() + chunk_size - 1) / chunk_size;
+    const int64_t rate_ppm = InterestEngine::rateToPpm(run_rate);
+
+    std::cout << "Interest run " << period << ": " << snapshot.size() << " savings account(s) in "
+              << chunk_count << " chunk(s)";
+    if (!already_posted.empty()) {
+        std::cout << ", " << already_posted.size() << " already posted";
+    }
+    std::cout << std::endl;
+
+    // Workers claim chunks in turn; computing runs in parallel, posting is serialized
+    std::atomic<size_t> next_chunk(0);
+    std::atomic<size_t> accounts_posted(0);
+    std::atomic<int64_t> interest_posted(0);
+    std::atomic<size_t> chunks_done(0);
+    std::atomic<bool> failed(false);
+
+    auto worker = [&]() {
+        size_t chunk;
+        while (!failed && (chunk = next_chunk++) < chunk_count) {
+            size_t begin = chunk * chunk_size;
+            size_t end = std::min(begin + chunk_size, snapshot.size());
+            InterestEngine::computeInterest(&snapshot.balances[begin], &snapshot.interest[begin], end - begin,
+                                            rate_ppm, BankingConstants::MONTHLY_INTEREST_DAYS);
+
+            Money chunk_interest;
+            size_t posted = 0;
+            bool chunk_ok = postInterestChunk(snapshot, begin, end, period, posted, chunk_interest);
+            accounts_posted += posted;
+            interest_posted += chunk_interest.minorUnits();
+            if (!chunk_ok) {
+                failed = true;
+                break;
+            }
+
+            size_t done = ++chunks_done;
+            if (done == chunk_count || done % 16 == 0) {
+                std::cout << "Interest run " << period << ": " << done << "/" << chunk_count
+                          << " chunks posted" << std::endl;
+            }
+        }
+    };
+
+    size_t worker_count = std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(), chunk_count));
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < worker_count; i++) {
+        workers.emplace_back(worker);
+    }
+    worker(); // The calling thread works too
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    if (failed) {
+        std::cerr << "Interest run " << period << " stopped after " << accounts_posted
+                  << " account(s); run it again to finish" << std::endl;
+        return;
+    }
+
+    db_handler.finishInterestRun(period);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    std::cout << "Interest run " << period << " complete: $" << Money::fromMinorUnits(interest_posted)
+              << " posted to " << accounts_posted << " account(s) in " << elapsed << "s" << std::endl;
+}
+
+// Month-end job: post interest at the default savings rate
+void BankSystem::runMonthlyInterestJob() {
+    applyInterestToAllSavingsAccounts(BankingConstants::DEFAULT_SAVINGS_INTEREST_RATE);
+}
+
+// Journal, credit and commit snapshot[begin, end). The INTEREST records are made
+// durable before any balance changes, so a failed flush leaves nothing credited
+// that a rerun would post again. balance_write_mutex is held only while crediting
+// and reading back the balances, so the balance writer sees all of a chunk or none.
+bool BankSystem::postInterestChunk(const InterestSnapshot& snapshot, size_t begin, size_t end,
+                                   const std::string& period, size_t& posted, Money& chunk_interest) {
+    posted = 0;
+    std::vector<size_t> rows;
+    rows.reserve(end - begin);
+    for (size_t i = begin; i < end; i++) {
+        if (snapshot.interest[i] > 0 && !snapshot.accounts[i]->isClosed()) {
+            rows.push_back(i); // Otherwise no interest due, or closed since the snapshot
+        }
+    }
+    if (rows.empty()) {
+        return true;
+    }
+
+    // One id reservation for the whole chunk
+    int first_id = 0;
+    if (!db_handler.reserveTransactionIds(static_cast<int>(rows.size()), first_id)) {
+        std::cerr << "Warning: Could not reserve transaction ids for an interest chunk" << std::endl;
+        return false;
+    }
+
+    std::string description = InterestEngine::describePeriod(period);
+    std::vector<std::shared_ptr<Transaction>> pending;
+    std::vector<uint64_t> lsns;
+    pending.reserve(rows.size());
+    lsns.reserve(rows.size());
+    for (size_t k = 0; k < rows.size(); k++) {
+        size_t i = rows[k];
+        auto transaction = std::make_shared<Transaction>(first_id + static_cast<int>(k), 0, snapshot.account_ids[i],
+                                                         Money::fromMinorUnits(snapshot.interest[i]),
+                                                         TransactionType::INTEREST, TransactionStatus::SUCCESS);
+        transaction->setDescription(description);
+        lsns.push_back(journal.append(JournalRecord::fromTransaction(*transaction)));
+        pending.push_back(transaction);
+    }
+
+    // One wait covers the whole chunk; after a failure, find which records made it
+    bool flushed = lsns.back() != 0 && journal.waitForDurable(lsns.back());
+    std::vector<bool> durable(pending.size(), flushed);
+    if (!flushed) {
+        for (size_t k = 0; k < pending.size(); k++) {
+            durable[k] = lsns[k] != 0 && journal.waitForDurable(lsns[k]);
+        }
+    }
+
+    // Credit only the rows whose records reached the journal: a rerun skips exactly those
+    std::vector<size_t> credited;
+    std::vector<std::shared_ptr<Transaction>> transactions;
+    std::vector<std::pair<int, Money>> balances;
+    credited.reserve(pending.size());
+    transactions.reserve(pending.size());
+    balances.reserve(pending.size());
+    {
+        std::lock_guard<std::mutex> lock(balance_write_mutex);
+        for (size_t k = 0; k < pending.size(); k++) {
+            const auto& account = snapshot.accounts[rows[k]];
+            if (!durable[k] || !account->postInterest(pending[k]->getAmount())) {
+                continue; // A closed account is skipped by recovery the same way
+            }
+            credited.push_back(rows[k]);
+            transactions.push_back(pending[k]);
+            balances.emplace_back(snapshot.account_ids[rows[k]], account->getBalance());
+        }
+    }
+    for (const auto& transaction : transactions) {
+        chunk_interest += transaction->getAmount();
+    }
+    posted = transactions.size();
+    total_transactions += static_cast<int>(posted);
+
+    if (!transactions.empty()) {
+        bool stored = db_handler.postInterestChunk(period, transactions, balances);
+        if (!stored) {
+            // The journal has the credits; let the balance writer retry the balances
+            std::cerr << "Warning: Failed to store an interest chunk in the database" << std::endl;
+        }
+        // A balance that moved after the credit may have been committed before this
+        // chunk; queue it again so the writer has the last word
+        for (size_t k = 0; k < credited.size(); k++) {
+            const auto& account = snapshot.accounts[credited[k]];
+            if (!stored || account->getBalance() != balances[k].second) {
+                markBalanceDirty(account);
+            }
+        }
+    }
+
+    if (!flushed) {
+        std::cerr << "Warning: Interest for " << pending.size() - posted
+                  << " account(s) did not reach the journal and was not credited" << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -3,16 +3,239 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
 
 // Static member initialization
 std::unique_ptr<DatabaseHandler> DatabaseHandler::instance = nullptr;
 std::mutex DatabaseHandler::instance_mutex;
 
+#ifdef USE_SQLITE
+// Money columns hold INTEGER cents (schema migration 1)
+static void bindMoney(sqlite3_stmt* stmt, int index, Money amount) {
+    sqlite3_bind_int64(stmt, index, amount.minorUnits());
+}
+
+static Money columnMoney(sqlite3_stmt* stmt, int index) {
+    return Money::fromMinorUnits(sqlite3_column_int64(stmt, index));
+}
+
+// Ids of 0 or less mean "none": NULL, which also lets AUTOINCREMENT pick a key
+static void bindId(sqlite3_stmt* stmt, int index, int id) {
+    if (id > 0) {
+        sqlite3_bind_int(stmt, index, id);
+    } else {
+        sqlite3_bind_null(stmt, index);
+    }
+}
+
+// A versioned schema change; each runs once per database, in version order
+struct SchemaMigration {
+    int version;
+    const char* description;
+    const char* sql;
+    bool rebuilds_tables; // Copies tables, so foreign key enforcement must be off
+};
+
+static const SchemaMigration SCHEMA_MIGRATIONS[] = {
+    {1, "Store money columns as INTEGER cents", R"(
+        CREATE TABLE Accounts_new (
+            account_id INTEGER PRIMARY KEY AUTOINCREMENT,
+            user_id INTEGER NOT NULL,
+            balance INTEGER NOT NULL DEFAULT 0,
+            account_type TEXT NOT NULL DEFAULT 'SAVINGS',
+            created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
+            updated_at DATETIME DEFAULT CURRENT_TIMESTAMP,
+            is_active INTEGER DEFAULT 1,
+            interest_rate REAL DEFAULT 0.0350,
+            minimum_balance INTEGER DEFAULT 0,
+            FOREIGN KEY (user_id) REFERENCES Users(user_id) ON DELETE CASCADE,
+            CHECK (balance >= 0),
+            CHECK (interest_rate >= 0 AND interest_rate <= 1),
+            CHECK (account_type IN ('SAVINGS', 'CURRENT'))
+        );
+        INSERT INTO Accounts_new (account_id, user_id, balance, account_type, created_at, updated_at,
+                                  is_active, interest_rate, minimum_balance)
+            SELECT account_id, user_id, CAST(ROUND(balance * 100) AS INTEGER), account_type, created_at, updated_at,
+                   is_active, interest_rate, CAST(ROUND(minimum_balance * 100) AS INTEGER)
+            FROM Accounts;
+        DROP TABLE Accounts;
+        ALTER TABLE Accounts_new RENAME TO Accounts;
+
+        CREATE TABLE Transactions_new (
+            transaction_id INTEGER PRIMARY KEY AUTOINCREMENT,
+            from_account_id INTEGER,
+            to_account_id INTEGER,
+            amount INTEGER NOT NULL,
+            transaction_type TEXT NOT NULL,
+            status TEXT NOT NULL DEFAULT 'PENDING',
+            description TEXT,
+            created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
+            completed_at DATETIME,
+            reference_number TEXT UNIQUE,
+            FOREIGN KEY (from_account_id) REFERENCES Accounts(account_id),
+            FOREIGN KEY (to_account_id) REFERENCES Accounts(account_id),
+            CHECK (amount > 0),
+            CHECK (transaction_type IN ('DEPOSIT', 'WITHDRAWAL', 'TRANSFER', 'INTEREST')),
+            CHECK (status IN ('SUCCESS', 'FAILED', 'PENDING'))
+        );
+        INSERT INTO Transactions_new (transaction_id, from_account_id, to_account_id, amount, transaction_type,
+                                      status, description, created_at, completed_at, reference_number)
+            SELECT transaction_id, from_account_id, to_account_id, CAST(ROUND(amount * 100) AS INTEGER),
+                   transaction_type, status, description, created_at, completed_at, reference_number
+            FROM Transactions;
+        DROP TABLE Transactions;
+        ALTER TABLE Transactions_new RENAME TO Transactions;
+    )", true},
+
+    // Each index holds every column its query reads, so lookups never touch the table
+    {2, "Covering indexes for account and history lookups", R"(
+        DROP INDEX IF EXISTS idx_transactions_from_history;
+        DROP INDEX IF EXISTS idx_transactions_to_history;
+        CREATE INDEX idx_transactions_from_history ON Transactions(
+            from_account_id, created_at DESC, transaction_id DESC,
+            to_account_id, amount, transaction_type, status, description);
+        CREATE INDEX idx_transactions_to_history ON Transactions(
+            to_account_id, created_at DESC, transaction_id DESC,
+            from_account_id, amount, transaction_type, status, description);
+        CREATE INDEX idx_accounts_user_active ON Accounts(
+            user_id, is_active, account_id, balance, account_type);
+    )", false},
+
+    // Every id below reserved_through has been leased to some process
+    {3, "Leased id sequences for users, accounts and transactions", R"(
+        CREATE TABLE id_sequences (
+            name TEXT PRIMARY KEY,
+            reserved_through INTEGER NOT NULL
+        );
+        INSERT INTO id_sequences (name, reserved_through)
+            SELECT 'users', COALESCE(MAX(user_id), 0) + 1 FROM Users;
+        INSERT INTO id_sequences (name, reserved_through)
+            SELECT 'accounts', COALESCE(MAX(account_id), 0) + 1 FROM Accounts;
+        INSERT INTO id_sequences (name, reserved_through)
+            SELECT 'transactions', COALESCE(MAX(transaction_id), 0) + 1 FROM Transactions;
+    )", false},
+
+    // One row per monthly interest run; progress is committed with each posted chunk
+    {4, "Interest run progress", R"(
+        CREATE TABLE interest_runs (
+            period TEXT PRIMARY KEY,
+            annual_rate REAL NOT NULL,
+            accounts_posted INTEGER NOT NULL DEFAULT 0,
+            interest_posted INTEGER NOT NULL DEFAULT 0,
+            started_at DATETIME DEFAULT CURRENT_TIMESTAMP,
+            completed_at DATETIME
+        );
+    )", false},
+};
+
+// Build a Transaction from a row of
+// (transaction_id, from_account_id, to_account_id, amount, transaction_type, status, description, created_at)
+static std::shared_ptr<Transaction> columnTransaction(sqlite3_stmt* stmt) {
+    int txn_id = sqlite3_column_int(stmt, 0);
+    int from_acc = sqlite3_column_type(stmt, 1) == SQLITE_NULL ? 0 : sqlite3_column_int(stmt, 1);
+    int to_acc = sqlite3_column_type(stmt, 2) == SQLITE_NULL ? 0 : sqlite3_column_int(stmt, 2);
+    Money amount = columnMoney(stmt, 3);
+
+    // Convert string to enum (simplified)
+    std::string type_str = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
+    TransactionType type = TransactionType::DEPOSIT;
+    if (type_str == "WITHDRAWAL") type = TransactionType::WITHDRAWAL;
+    else if (type_str == "TRANSFER") type = TransactionType::TRANSFER;
+    else if (type_str == "INTEREST") type = TransactionType::INTEREST;
+
+    std::string status_str = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
+    TransactionStatus status = TransactionStatus::PENDING;
+    if (status_str == "SUCCESS") status = TransactionStatus::SUCCESS;
+    else if (status_str == "FAILED") status = TransactionStatus::FAILED;
+
+    auto transaction = std::make_shared<Transaction>(txn_id, from_acc, to_acc, amount, type, status);
+
+    if (sqlite3_column_type(stmt, 6) != SQLITE_NULL) {
+        transaction->setDescription(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6)));
+    }
+    if (sqlite3_column_type(stmt, 7) != SQLITE_NULL) {
+        transaction->setTimestamp(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 7)));
+    }
+    return transaction;
+}
+
+// Resets a cached statement and clears its bindings when the caller is done with it
+class StatementReset {
+public:
+    explicit StatementReset(sqlite3_stmt* stmt) : stmt(stmt) {}
+    ~StatementReset() {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    }
+
+    StatementReset(const StatementReset&) = delete;
+    StatementReset& operator=(const StatementReset&) = delete;
+
+private:
+    sqlite3_stmt* stmt;
+};
+
+// Borrows a pooled reader for the scope of one query
+class DatabaseHandler::ReaderLease {
+public:
+    explicit ReaderLease(DatabaseHandler& handler) : handler(handler), reader(handler.acquireReader()) {}
+    ~ReaderLease() {
+        if (reader) {
+            handler.releaseReader(std::move(reader));
+        }
+    }
+
+    ReaderLease(const ReaderLease&) = delete;
+    ReaderLease& operator=(const ReaderLease&) = delete;
+
+    ReaderConnection* get() const { return reader.get(); }
+
+private:
+    DatabaseHandler& handler;
+    std::unique_ptr<ReaderConnection> reader;
+};
+#endif
+
+// History cursors are "<created_at>|<transaction_id>" of the last row returned.
+// Callers treat them as opaque and only hand them back.
+static std::string makeHistoryCursor(const std::string& created_at, int transaction_id) {
+    return created_at + "|" + std::to_string(transaction_id);
+}
+
+static bool parseHistoryCursor(const std::string& cursor, std::string& created_at, int& transaction_id) {
+    size_t separator = cursor.rfind('|');
+    if (separator == std::string::npos || separator == 0 || separator + 1 == cursor.size()) {
+        return false;
+    }
+
+    try {
+        size_t parsed = 0;
+        transaction_id = std::stoi(cursor.substr(separator + 1), &parsed);
+        if (parsed != cursor.size() - separator - 1) {
+            return false;
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    created_at = cursor.substr(0, separator);
+    return true;
+}
+
 // Private constructor
-DatabaseHandler::DatabaseHandler() : connected(false) {
+DatabaseHandler::DatabaseHandler()
+    : connected(false), statement_cache_hits(0), statement_cache_misses(0),
+      writer_running(false), writer_stopping(false), write_batches_committed(0), writes_committed(0),
+      user_ids("users", BankingConstants::ID_BLOCK_SIZE, reserveIdBlockFn()),
+      account_ids("accounts", BankingConstants::ID_BLOCK_SIZE, reserveIdBlockFn()),
+      transaction_ids("transactions", BankingConstants::ID_BLOCK_SIZE, reserveIdBlockFn()) {
 #ifdef USE_SQLITE
     db = nullptr;
     db_path = "banking_system.db";
+    open_readers = 0;
+    for (auto& stmt : statement_cache) {
+        stmt = nullptr;
+    }
 #endif
 }
 
@@ -46,9 +269,15 @@ bool DatabaseHandler::connect(const std::string& connection_info) {
         }
 
         connected = true;
+        db_path = db_file; // Readers open the same file
         std::cout << "Connected to SQLite database: " << db_file << std::endl;
 
-        return initializeDatabase();
+        if (!initializeDatabase()) {
+            return false;
+        }
+
+        startWriter();
+        return true;
 #else
         (void)connection_info; // Suppress unused parameter warning
         std::cerr << "SQLite support not compiled in" << std::endl;
@@ -64,6 +293,8 @@ bool DatabaseHandler::connect(const std::string& connection_info) {
 
 // Disconnect from database
 void DatabaseHandler::disconnect() {
+    stopWriter(); // Drains the queue, which needs db_mutex
+
     std::lock_guard<std::mutex> lock(db_mutex);
     
 #ifdef USE_MYSQL
@@ -72,8 +303,15 @@ void DatabaseHandler::disconnect() {
     }
 #endif
 
+    // Leases belong to this database
+    user_ids.reset();
+    account_ids.reset();
+    transaction_ids.reset();
+
 #ifdef USE_SQLITE
+    closeReaders();
     if (db) {
+        finalizeCachedStatements();
         sqlite3_close(db);
         db = nullptr;
     }
@@ -87,6 +325,325 @@ bool DatabaseHandler::isConnected() const {
     return connected;
 }
 
+#ifdef USE_SQLITE
+// Return the writer's prepared statement for id, preparing it on first use
+sqlite3_stmt* DatabaseHandler::prepareCached(StatementId id, const char* sql) {
+    return prepareInto(db, statement_cache[static_cast<size_t>(id)], sql);
+}
+
+// Same, for a reader's own statements
+sqlite3_stmt* DatabaseHandler::prepareCached(ReaderConnection& reader, StatementId id, const char* sql) {
+    return prepareInto(reader.handle, reader.statements[static_cast<size_t>(id)], sql);
+}
+
+sqlite3_stmt* DatabaseHandler::prepareInto(sqlite3* handle, sqlite3_stmt*& slot, const char* sql) {
+    if (slot) {
+        statement_cache_hits++;
+        return slot;
+    }
+
+    statement_cache_misses++;
+    if (sqlite3_prepare_v3(handle, sql, -1, SQLITE_PREPARE_PERSISTENT, &slot, nullptr) != SQLITE_OK) {
+        slot = nullptr;
+        return nullptr;
+    }
+    return slot;
+}
+
+// Finalize every cached statement (must run before the connection closes)
+void DatabaseHandler::finalizeCachedStatements() {
+    for (auto& stmt : statement_cache) {
+        if (stmt) {
+            sqlite3_finalize(stmt);
+            stmt = nullptr;
+        }
+    }
+}
+
+// Take an idle reader, open a new one while the pool has room, or wait for one
+std::unique_ptr<ReaderConnection> DatabaseHandler::acquireReader() {
+    std::unique_lock<std::mutex> lock(reader_mutex);
+    reader_cv.wait(lock, [this] {
+        return !idle_readers.empty() || open_readers < static_cast<size_t>(BankingConstants::DB_READER_POOL_SIZE);
+    });
+
+    if (!idle_readers.empty()) {
+        auto reader = std::move(idle_readers.back());
+        idle_readers.pop_back();
+        return reader;
+    }
+
+    open_readers++;
+    lock.unlock();
+
+    auto reader = std::make_unique<ReaderConnection>();
+    // Each reader is used by one thread at a time, so SQLite's own mutex is not needed
+    int flags = SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX;
+    if (sqlite3_open_v2(db_path.c_str(), &reader->handle, flags, nullptr) != SQLITE_OK) {
+        std::cerr << "Cannot open read connection: " << sqlite3_errmsg(reader->handle) << std::endl;
+        sqlite3_close(reader->handle);
+
+        lock.lock();
+        open_readers--;
+        reader_cv.notify_one();
+        return nullptr;
+    }
+    sqlite3_busy_timeout(reader->handle, 100);
+    return reader;
+}
+
+// Return a reader to the pool
+void DatabaseHandler::releaseReader(std::unique_ptr<ReaderConnection> reader) {
+    std::lock_guard<std::mutex> lock(reader_mutex);
+    idle_readers.push_back(std::move(reader));
+    reader_cv.notify_one();
+}
+
+// Wait for borrowed readers to come back, then close them all
+void DatabaseHandler::closeReaders() {
+    std::unique_lock<std::mutex> lock(reader_mutex);
+    reader_cv.wait(lock, [this] { return idle_readers.size() == open_readers; });
+
+    for (auto& reader : idle_readers) {
+        for (auto& stmt : reader->statements) {
+            if (stmt) {
+                sqlite3_finalize(stmt);
+            }
+        }
+        sqlite3_close(reader->handle);
+    }
+    idle_readers.clear();
+    open_readers = 0;
+}
+
+// Run one queued write on the writer connection (caller holds db_mutex inside a transaction)
+int DatabaseHandler::executeWrite(const PendingWrite& write) {
+    if (write.kind == PendingWrite::Kind::UPDATE_ACCOUNT) {
+        return stepAccountUpdate(write.account_id, write.balance);
+    }
+    return stepTransactionInsert(write.transaction_id, write.from_account_id, write.to_account_id, write.amount,
+                                 write.type, write.status, write.description);
+}
+
+// Set one account's balance with the cached update statement; returns the sqlite3_step result
+int DatabaseHandler::stepAccountUpdate(int account_id, Money balance) {
+    const char* sql = "UPDATE Accounts SET balance = ?, updated_at = CURRENT_TIMESTAMP WHERE account_id = ?";
+    sqlite3_stmt* stmt = prepareCached(StatementId::UPDATE_ACCOUNT, sql);
+    if (!stmt) {
+        return SQLITE_ERROR;
+    }
+    StatementReset reset_on_exit(stmt);
+
+    bindMoney(stmt, 1, balance);
+    sqlite3_bind_int(stmt, 2, account_id);
+    return sqlite3_step(stmt);
+}
+
+// Insert one transaction row with the cached insert statement; returns the sqlite3_step result
+int DatabaseHandler::stepTransactionInsert(int transaction_id, int from_account_id, int to_account_id, Money amount,
+                                           const std::string& type, const std::string& status,
+                                           const std::string& description) {
+    const char* sql = "INSERT INTO Transactions (transaction_id, from_account_id, to_account_id, amount, transaction_type, status, description) VALUES (?, ?, ?, ?, ?, ?, ?)";
+    sqlite3_stmt* stmt = prepareCached(StatementId::INSERT_TRANSACTION, sql);
+    if (!stmt) {
+        return SQLITE_ERROR;
+    }
+    StatementReset reset_on_exit(stmt);
+
+    bindId(stmt, 1, transaction_id);
+    bindId(stmt, 2, from_account_id);
+    bindId(stmt, 3, to_account_id);
+    bindMoney(stmt, 4, amount);
+    sqlite3_bind_text(stmt, 5, type.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 6, status.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 7, description.c_str(), -1, SQLITE_STATIC);
+    return sqlite3_step(stmt);
+}
+
+// Open the write transaction for a bulk operation (caller holds db_mutex)
+bool DatabaseHandler::beginBulkWrite() {
+    char* error_msg = nullptr;
+    if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, &error_msg) != SQLITE_OK) {
+        std::cerr << "Failed to start bulk write: " << (error_msg ? error_msg : sqlite3_errmsg(db)) << std::endl;
+        sqlite3_free(error_msg);
+        return false;
+    }
+    return true;
+}
+
+// Commit a bulk operation, rolling it back if the commit fails (caller holds db_mutex)
+bool DatabaseHandler::commitBulkWrite() {
+    char* error_msg = nullptr;
+    if (sqlite3_exec(db, "COMMIT;", nullptr, nullptr, &error_msg) != SQLITE_OK) {
+        std::cerr << "Failed to commit bulk write: " << (error_msg ? error_msg : sqlite3_errmsg(db)) << std::endl;
+        sqlite3_free(error_msg);
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+    return true;
+}
+
+// Insert rows inside an open bulk write; stops at the first failure
+bool DatabaseHandler::stepTransactionInserts(const std::vector<std::shared_ptr<Transaction>>& transactions) {
+    for (const auto& transaction : transactions) {
+        int result = stepTransactionInsert(transaction->getTransactionId(), transaction->getFromAccountId(),
+                                           transaction->getToAccountId(), transaction->getAmount(),
+                                           transaction->getTypeString(), transaction->getStatusString(),
+                                           transaction->getDescription());
+        if (result != SQLITE_DONE) {
+            std::cerr << "Failed to insert transaction " << transaction->getTransactionId() << ": "
+                      << sqlite3_errmsg(db) << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Update balances inside an open bulk write; stops at the first failure
+bool DatabaseHandler::stepAccountUpdates(const std::vector<std::pair<int, Money>>& balances) {
+    for (const auto& [account_id, balance] : balances) {
+        if (stepAccountUpdate(account_id, balance) != SQLITE_DONE) {
+            std::cerr << "Failed to update account " << account_id << ": " << sqlite3_errmsg(db) << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+// Start the writer thread
+void DatabaseHandler::startWriter() {
+    std::lock_guard<std::mutex> lock(write_queue_mutex);
+    if (writer_running) {
+        return;
+    }
+
+    writer_stopping = false;
+    writer_running = true;
+    writer_thread = std::thread(&DatabaseHandler::writerLoop, this);
+}
+
+// Commit everything still queued, then stop the writer thread
+void DatabaseHandler::stopWriter() {
+    {
+        std::lock_guard<std::mutex> lock(write_queue_mutex);
+        if (!writer_running) {
+            return;
+        }
+        writer_stopping = true;
+    }
+    write_queue_cv.notify_all();
+
+    if (writer_thread.joinable()) {
+        writer_thread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(write_queue_mutex);
+    writer_running = false;
+}
+
+// Hand a write to the writer thread
+std::future<bool> DatabaseHandler::enqueueWrite(PendingWrite write) {
+    std::future<bool> result = write.done.get_future();
+    {
+        std::lock_guard<std::mutex> lock(write_queue_mutex);
+        if (!writer_running || writer_stopping) {
+            std::cerr << "Database writer is not running" << std::endl;
+            write.done.set_value(false);
+            return result;
+        }
+        write_queue.push_back(std::move(write));
+    }
+    write_queue_cv.notify_one();
+    return result;
+}
+
+// Writer thread main loop
+void DatabaseHandler::writerLoop() {
+    std::unique_lock<std::mutex> lock(write_queue_mutex);
+    while (true) {
+        write_queue_cv.wait(lock, [this]() { return writer_stopping || !write_queue.empty(); });
+        if (write_queue.empty()) {
+            break; // Stopping with nothing left to commit
+        }
+
+        // Give concurrent writers a short window to join this batch
+        const size_t batch_limit = static_cast<size_t>(BankingConstants::DB_WRITE_BATCH_LIMIT);
+        if (!writer_stopping && write_queue.size() < batch_limit && BankingConstants::DB_WRITE_BATCH_MICROS > 0) {
+            write_queue_cv.wait_for(lock, std::chrono::microseconds(BankingConstants::DB_WRITE_BATCH_MICROS),
+                                    [this, batch_limit]() { return writer_stopping || write_queue.size() >= batch_limit; });
+        }
+
+        std::vector<PendingWrite> batch;
+        size_t batch_size = std::min(write_queue.size(), batch_limit);
+        batch.reserve(batch_size);
+        for (size_t i = 0; i < batch_size; i++) {
+            batch.push_back(std::move(write_queue.front()));
+            write_queue.pop_front();
+        }
+        lock.unlock();
+
+        commitWriteBatch(batch);
+
+        lock.lock();
+    }
+}
+
+// Apply one batch in a single transaction and resolve every write's future
+void DatabaseHandler::commitWriteBatch(std::vector<PendingWrite>& batch) {
+    std::vector<bool> results(batch.size(), false);
+    bool committed = false;
+
+#ifdef USE_SQLITE
+    {
+        std::lock_guard<std::mutex> lock(db_mutex);
+
+        char* error_msg = nullptr;
+        if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, &error_msg) != SQLITE_OK) {
+            std::cerr << "Failed to start write batch: " << (error_msg ? error_msg : sqlite3_errmsg(db)) << std::endl;
+            sqlite3_free(error_msg);
+        } else {
+            bool aborted = false;
+            for (size_t i = 0; i < batch.size(); i++) {
+                int result = executeWrite(batch[i]);
+                if (result == SQLITE_DONE) {
+                    results[i] = true;
+                    continue;
+                }
+
+                std::cerr << (batch[i].kind == PendingWrite::Kind::UPDATE_ACCOUNT ? "Failed to update account: "
+                                                                                   : "Failed to insert transaction: ")
+                          << sqlite3_errmsg(db) << std::endl;
+                // A constraint error fails one statement; anything that ended the transaction fails the batch
+                if (sqlite3_get_autocommit(db)) {
+                    aborted = true;
+                    break;
+                }
+            }
+
+            if (!aborted && sqlite3_exec(db, "COMMIT;", nullptr, nullptr, &error_msg) == SQLITE_OK) {
+                committed = true;
+            } else {
+                if (!aborted) {
+                    std::cerr << "Failed to commit write batch: " << (error_msg ? error_msg : sqlite3_errmsg(db)) << std::endl;
+                    sqlite3_free(error_msg);
+                }
+                sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+            }
+        }
+    }
+#endif
+
+    if (committed) {
+        write_batches_committed++;
+        writes_committed += std::count(results.begin(), results.end(), true);
+    }
+
+    for (size_t i = 0; i < batch.size(); i++) {
+        batch[i].done.set_value(committed && results[i]);
+    }
+}
+
 // Initialize database
 bool DatabaseHandler::initializeDatabase() {
     if (!connected) {
@@ -100,10 +657,95 @@ bool DatabaseHandler::initializeDatabase() {
     sqlite3_exec(db, "PRAGMA synchronous = NORMAL;", nullptr, nullptr, nullptr);
     sqlite3_exec(db, "PRAGMA cache_size = 10000;", nullptr, nullptr, nullptr);
     sqlite3_exec(db, "PRAGMA temp_store = memory;", nullptr, nullptr, nullptr);
-    sqlite3_busy_timeout(db, 100); // Very short timeout to prevent hanging
+    // Writes wait for other processes holding the lock; a busy failure is reported, not ignored
+    sqlite3_busy_timeout(db, 5000);
+#endif
+
+    return createTables() && migrateSchema();
+}
+
+// Bring an existing database up to the latest schema version in place
+bool DatabaseHandler::migrateSchema() {
+#ifdef USE_SQLITE
+    char* error_msg = nullptr;
+    const char* create_migrations = R"(
+        CREATE TABLE IF NOT EXISTS schema_migrations (
+            version INTEGER PRIMARY KEY,
+            description TEXT NOT NULL,
+            applied_at DATETIME DEFAULT CURRENT_TIMESTAMP
+        )
+    )";
+    if (sqlite3_exec(db, create_migrations, nullptr, nullptr, &error_msg) != SQLITE_OK) {
+        std::cerr << "Error creating schema_migrations table: " << error_msg << std::endl;
+        sqlite3_free(error_msg);
+        return false;
+    }
+
+    int current_version = getSchemaVersion();
+    if (current_version < 0) {
+        return false;
+    }
+
+    bool success = true;
+    for (const auto& migration : SCHEMA_MIGRATIONS) {
+        if (migration.version <= current_version) {
+            continue;
+        }
+
+        // PRAGMA foreign_keys is ignored inside a transaction, so toggle it outside
+        if (migration.rebuilds_tables) {
+            sqlite3_exec(db, "PRAGMA foreign_keys = OFF;", nullptr, nullptr, nullptr);
+        }
+
+        std::string record_sql = "INSERT INTO schema_migrations (version, description) VALUES (" +
+                                 std::to_string(migration.version) + ", '" + migration.description + "');";
+        bool applied = sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, &error_msg) == SQLITE_OK &&
+                       sqlite3_exec(db, migration.sql, nullptr, nullptr, &error_msg) == SQLITE_OK &&
+                       sqlite3_exec(db, record_sql.c_str(), nullptr, nullptr, &error_msg) == SQLITE_OK &&
+                       sqlite3_exec(db, "COMMIT;", nullptr, nullptr, &error_msg) == SQLITE_OK;
+
+        if (!applied) {
+            std::cerr << "Schema migration " << migration.version << " failed: "
+                      << (error_msg ? error_msg : sqlite3_errmsg(db)) << std::endl;
+            sqlite3_free(error_msg);
+            error_msg = nullptr;
+            sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        }
+
+        if (migration.rebuilds_tables) {
+            sqlite3_exec(db, "PRAGMA foreign_keys = ON;", nullptr, nullptr, nullptr);
+        }
+
+        if (!applied) {
+            success = false;
+            break;
+        }
+        std::cout << "Applied schema migration " << migration.version << ": " << migration.description << std::endl;
+    }
+
+    return success;
+#else
+    return false;
 #endif
+}
+
+// Highest applied migration version (0 for a fresh database, -1 on error)
+int DatabaseHandler::getSchemaVersion() {
+#ifdef USE_SQLITE
+    const char* sql = "SELECT COALESCE(MAX(version), 0) FROM schema_migrations";
+    sqlite3_stmt* stmt;
+
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Failed to read schema version: " << sqlite3_errmsg(db) << std::endl;
+        return -1;
+    }
 
-    return createTables();
+    int version = sqlite3_step(stmt) == SQLITE_ROW ? sqlite3_column_int(stmt, 0) : -1;
+    sqlite3_finalize(stmt);
+    return version;
+#else
+    return -1;
+#endif
 }
 
 // Create tables
@@ -204,20 +846,20 @@ bool DatabaseHandler::insertUser(const User& user) {
 
     try {
 #ifdef USE_SQLITE
-        const char* sql = "INSERT INTO Users (name, email, password_hash) VALUES (?, ?, ?)";
-        sqlite3_stmt* stmt;
-
-        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        const char* sql = "INSERT INTO Users (user_id, name, email, password_hash) VALUES (?, ?, ?, ?)";
+        sqlite3_stmt* stmt = prepareCached(StatementId::INSERT_USER, sql);
+        if (!stmt) {
             std::cerr << "Failed to prepare insert user statement: " << sqlite3_errmsg(db) << std::endl;
             return false;
         }
+        StatementReset reset_on_exit(stmt);
 
-        sqlite3_bind_text(stmt, 1, user.getName().c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt, 2, user.getEmail().c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt, 3, user.getPasswordHash().c_str(), -1, SQLITE_TRANSIENT);
+        bindId(stmt, 1, user.getUserId());
+        sqlite3_bind_text(stmt, 2, user.getName().c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 3, user.getEmail().c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 4, user.getPasswordHash().c_str(), -1, SQLITE_TRANSIENT);
 
         int result = sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
 
         if (result == SQLITE_DONE) {
             std::cout << "User inserted successfully" << std::endl;
@@ -241,17 +883,20 @@ bool DatabaseHandler::insertUser(const User& user) {
 std::shared_ptr<User> DatabaseHandler::getUserByEmail(const std::string& email) {
     if (!connected) return nullptr;
 
-    std::lock_guard<std::mutex> lock(db_mutex);
-
     try {
 #ifdef USE_SQLITE
-        const char* sql = "SELECT user_id, name, email, password_hash FROM Users WHERE email = ? AND is_active = 1";
-        sqlite3_stmt* stmt;
+        ReaderLease reader(*this);
+        if (!reader.get()) {
+            return nullptr;
+        }
 
-        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
-            std::cerr << "Failed to prepare get user statement: " << sqlite3_errmsg(db) << std::endl;
+        const char* sql = "SELECT user_id, name, email, password_hash FROM Users WHERE email = ? AND is_active = 1";
+        sqlite3_stmt* stmt = prepareCached(*reader.get(), StatementId::GET_USER_BY_EMAIL, sql);
+        if (!stmt) {
+            std::cerr << "Failed to prepare get user statement: " << sqlite3_errmsg(reader.get()->handle) << std::endl;
             return nullptr;
         }
+        StatementReset reset_on_exit(stmt);
 
         sqlite3_bind_text(stmt, 1, email.c_str(), -1, SQLITE_STATIC);
 
@@ -267,11 +912,9 @@ std::shared_ptr<User> DatabaseHandler::getUserByEmail(const std::string& email)
             std::string user_email = email_ptr ? email_ptr : "";
             std::string password_hash = hash_ptr ? hash_ptr : "";
 
-            sqlite3_finalize(stmt);
             return std::make_shared<User>(user_id, name, user_email, password_hash);
         }
 
-        sqlite3_finalize(stmt);
 #endif
         return nullptr;
     }
@@ -289,20 +932,20 @@ bool DatabaseHandler::insertAccount(const Account& account) {
 
     try {
 #ifdef USE_SQLITE
-        const char* sql = "INSERT INTO Accounts (user_id, balance, account_type) VALUES (?, ?, ?)";
-        sqlite3_stmt* stmt;
-
-        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        const char* sql = "INSERT INTO Accounts (account_id, user_id, balance, account_type) VALUES (?, ?, ?, ?)";
+        sqlite3_stmt* stmt = prepareCached(StatementId::INSERT_ACCOUNT, sql);
+        if (!stmt) {
             std::cerr << "Failed to prepare insert account statement: " << sqlite3_errmsg(db) << std::endl;
             return false;
         }
+        StatementReset reset_on_exit(stmt);
 
-        sqlite3_bind_int(stmt, 1, account.getUserId());
-        sqlite3_bind_double(stmt, 2, account.getBalance());
-        sqlite3_bind_text(stmt, 3, account.getAccountTypeString().c_str(), -1, SQLITE_TRANSIENT);
+        bindId(stmt, 1, account.getAccountId());
+        sqlite3_bind_int(stmt, 2, account.getUserId());
+        bindMoney(stmt, 3, account.getBalance());
+        sqlite3_bind_text(stmt, 4, account.getAccountTypeString().c_str(), -1, SQLITE_TRANSIENT);
 
         int result = sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
 
         if (result == SQLITE_DONE) {
             std::cout << "Account created successfully with ID: " << sqlite3_last_insert_rowid(db) << std::endl;
@@ -325,70 +968,73 @@ bool DatabaseHandler::insertAccount(const Account& account) {
 // Get next user ID
 int DatabaseHandler::getNextUserId() {
     if (!connected) return 1;
-    
-    std::lock_guard<std::mutex> lock(db_mutex);
-    
-#ifdef USE_SQLITE
-    const char* sql = "SELECT COALESCE(MAX(user_id), 0) + 1 FROM Users";
-    sqlite3_stmt* stmt;
-    
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            int next_id = sqlite3_column_int(stmt, 0);
-            sqlite3_finalize(stmt);
-            return next_id;
-        }
-        sqlite3_finalize(stmt);
-    }
-#endif
-    
-    return 1;
+    return user_ids.next();
 }
 
 // Get next account ID
 int DatabaseHandler::getNextAccountId() {
     if (!connected) return 1;
-    
-    std::lock_guard<std::mutex> lock(db_mutex);
-    
-#ifdef USE_SQLITE
-    const char* sql = "SELECT COALESCE(MAX(account_id), 0) + 1 FROM Accounts";
-    sqlite3_stmt* stmt;
-    
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            int next_id = sqlite3_column_int(stmt, 0);
-            sqlite3_finalize(stmt);
-            return next_id;
-        }
-        sqlite3_finalize(stmt);
-    }
-#endif
-    
-    return 1;
+    return account_ids.next();
 }
 
 // Get next transaction ID
 int DatabaseHandler::getNextTransactionId() {
     if (!connected) return 1;
-    
+    return transaction_ids.next();
+}
+
+// Reserve count consecutive transaction ids outside the allocator's lease (e.g. one interest chunk)
+bool DatabaseHandler::reserveTransactionIds(int count, int& first_id) {
+    return count > 0 && reserveIdBlock(transaction_ids.getSequence(), count, first_id);
+}
+
+// Callback the id allocators use to lease blocks from id_sequences
+IdAllocator::BlockReserver DatabaseHandler::reserveIdBlockFn() {
+    return [this](const std::string& sequence, int block_size, int& first_id) {
+        return reserveIdBlock(sequence, block_size, first_id);
+    };
+}
+
+// Lease the next block_size ids of a sequence. The single UPDATE is atomic,
+// so processes sharing the database never receive overlapping blocks.
+bool DatabaseHandler::reserveIdBlock(const std::string& sequence, int block_size, int& first_id) {
+    if (!connected) return false;
+
     std::lock_guard<std::mutex> lock(db_mutex);
-    
+
 #ifdef USE_SQLITE
-    const char* sql = "SELECT COALESCE(MAX(transaction_id), 0) + 1 FROM Transactions";
-    sqlite3_stmt* stmt;
-    
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            int next_id = sqlite3_column_int(stmt, 0);
-            sqlite3_finalize(stmt);
-            return next_id;
-        }
-        sqlite3_finalize(stmt);
+    const char* sql = "UPDATE id_sequences SET reserved_through = reserved_through + ?2 WHERE name = ?1 "
+                      "RETURNING reserved_through - ?2";
+    sqlite3_stmt* stmt = prepareCached(StatementId::RESERVE_ID_BLOCK, sql);
+    if (!stmt) {
+        std::cerr << "Failed to prepare id reservation statement: " << sqlite3_errmsg(db) << std::endl;
+        return false;
     }
+    StatementReset reset_on_exit(stmt);
+
+    sqlite3_bind_text(stmt, 1, sequence.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 2, block_size);
+
+    if (sqlite3_step(stmt) != SQLITE_ROW) {
+        std::cerr << "Failed to reserve ids for " << sequence << ": " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    sqlite3_int64 first = sqlite3_column_int64(stmt, 0);
+
+    // Stepping to the end completes the statement, committing the reservation
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        std::cerr << "Failed to reserve ids for " << sequence << ": " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+
+    first_id = static_cast<int>(first);
+    return true;
+#else
+    (void)sequence;
+    (void)block_size;
+    (void)first_id;
+    return false;
 #endif
-    
-    return 1;
 }
 
 // Begin transaction
@@ -428,44 +1074,53 @@ bool DatabaseHandler::updateAccount(const Account& account) {
         return false;
     }
 
+    return updateAccountAsync(account).get();
+}
+
+// Queue a balance update; the future is true once it has committed
+std::future<bool> DatabaseHandler::updateAccountAsync(const Account& account) {
+    PendingWrite write;
+    write.kind = PendingWrite::Kind::UPDATE_ACCOUNT;
+    write.account_id = account.getAccountId();
+    write.balance = account.getBalance();
+    return enqueueWrite(std::move(write));
+}
+
+// Delete account (soft delete: the row and its history are kept, but it is no longer active)
+bool DatabaseHandler::deleteAccount(int account_id) {
+    if (!connected) {
+        std::cerr << "Database not connected" << std::endl;
+        return false;
+    }
+
     std::lock_guard<std::mutex> lock(db_mutex);
 
     try {
 #ifdef USE_SQLITE
-        const char* sql = "UPDATE Accounts SET balance = ?, updated_at = CURRENT_TIMESTAMP WHERE account_id = ?";
-        sqlite3_stmt* stmt;
-
-        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
-            std::cerr << "Failed to prepare update account statement: " << sqlite3_errmsg(db) << std::endl;
+        const char* sql = "UPDATE Accounts SET is_active = 0, updated_at = CURRENT_TIMESTAMP WHERE account_id = ? AND is_active = 1";
+        sqlite3_stmt* stmt = prepareCached(StatementId::DELETE_ACCOUNT, sql);
+        if (!stmt) {
+            std::cerr << "Failed to prepare delete account statement: " << sqlite3_errmsg(db) << std::endl;
             return false;
         }
+        StatementReset reset_on_exit(stmt);
 
-        sqlite3_bind_double(stmt, 1, account.getBalance());
-        sqlite3_bind_int(stmt, 2, account.getAccountId());
-
-        // Use immediate mode to prevent hanging
-        sqlite3_busy_timeout(db, 0); // No waiting - immediate response
+        sqlite3_bind_int(stmt, 1, account_id);
 
         int result = sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
 
-        if (result == SQLITE_DONE) {
-            return true;
-        } else if (result == SQLITE_BUSY) {
-            // Database is busy, but don't fail - just log and continue
-            std::cout << "Database busy, continuing with in-memory operation" << std::endl;
-            return true; // Return success to avoid rollback
-        } else {
-            std::cerr << "Failed to update account: " << sqlite3_errmsg(db) << std::endl;
+        if (result != SQLITE_DONE) {
+            std::cerr << "Failed to delete account: " << sqlite3_errmsg(db) << std::endl;
             return false;
         }
+        return sqlite3_changes(db) > 0;
 #else
-        (void)account; // Suppress unused parameter warning
+        (void)account_id; // Suppress unused parameter warning
         return false;
 #endif
     }
     catch (const std::exception& e) {
-        std::cerr << "Error updating account: " << e.what() << std::endl;
+        std::cerr << "Error deleting account: " << e.what() << std::endl;
         return false;
     }
 }
@@ -474,32 +1129,33 @@ bool DatabaseHandler::updateAccount(const Account& account) {
 std::shared_ptr<Account> DatabaseHandler::getAccountById(int account_id) {
     if (!connected) return nullptr;
 
-    std::lock_guard<std::mutex> lock(db_mutex);
-
     try {
 #ifdef USE_SQLITE
-        const char* sql = "SELECT account_id, user_id, balance, account_type FROM Accounts WHERE account_id = ? AND is_active = 1";
-        sqlite3_stmt* stmt;
+        ReaderLease reader(*this);
+        if (!reader.get()) {
+            return nullptr;
+        }
 
-        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        const char* sql = "SELECT account_id, user_id, balance, account_type FROM Accounts WHERE account_id = ? AND is_active = 1";
+        sqlite3_stmt* stmt = prepareCached(*reader.get(), StatementId::GET_ACCOUNT_BY_ID, sql);
+        if (!stmt) {
             return nullptr;
         }
+        StatementReset reset_on_exit(stmt);
 
         sqlite3_bind_int(stmt, 1, account_id);
 
         if (sqlite3_step(stmt) == SQLITE_ROW) {
             int acc_id = sqlite3_column_int(stmt, 0);
             int user_id = sqlite3_column_int(stmt, 1);
-            double balance = sqlite3_column_double(stmt, 2);
+            Money balance = columnMoney(stmt, 2);
             std::string type_str = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
 
             AccountType type = (type_str == "SAVINGS") ? AccountType::SAVINGS : AccountType::CURRENT;
 
-            sqlite3_finalize(stmt);
             return std::make_shared<Account>(acc_id, user_id, balance, type);
         }
 
-        sqlite3_finalize(stmt);
 #endif
         return nullptr;
     }
@@ -515,23 +1171,26 @@ std::vector<std::shared_ptr<Account>> DatabaseHandler::getAccountsByUserId(int u
 
     if (!connected) return accounts;
 
-    std::lock_guard<std::mutex> lock(db_mutex);
-
     try {
 #ifdef USE_SQLITE
-        const char* sql = "SELECT account_id, user_id, balance, account_type FROM Accounts WHERE user_id = ? AND is_active = 1";
-        sqlite3_stmt* stmt;
+        ReaderLease reader(*this);
+        if (!reader.get()) {
+            return accounts;
+        }
 
-        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        const char* sql = "SELECT account_id, user_id, balance, account_type FROM Accounts WHERE user_id = ? AND is_active = 1";
+        sqlite3_stmt* stmt = prepareCached(*reader.get(), StatementId::GET_ACCOUNTS_BY_USER_ID, sql);
+        if (!stmt) {
             return accounts;
         }
+        StatementReset reset_on_exit(stmt);
 
         sqlite3_bind_int(stmt, 1, user_id);
 
         while (sqlite3_step(stmt) == SQLITE_ROW) {
             int acc_id = sqlite3_column_int(stmt, 0);
             int uid = sqlite3_column_int(stmt, 1);
-            double balance = sqlite3_column_double(stmt, 2);
+            Money balance = columnMoney(stmt, 2);
             std::string type_str = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
 
             AccountType type = (type_str == "SAVINGS") ? AccountType::SAVINGS : AccountType::CURRENT;
@@ -539,7 +1198,6 @@ std::vector<std::shared_ptr<Account>> DatabaseHandler::getAccountsByUserId(int u
             accounts.push_back(std::make_shared<Account>(acc_id, uid, balance, type));
         }
 
-        sqlite3_finalize(stmt);
 #endif
         return accounts;
     }
@@ -560,11 +1218,11 @@ std::vector<std::shared_ptr<User>> DatabaseHandler::getAllUsers() {
     try {
 #ifdef USE_SQLITE
         const char* sql = "SELECT user_id, name, email, password_hash FROM Users WHERE is_active = 1";
-        sqlite3_stmt* stmt;
-
-        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        sqlite3_stmt* stmt = prepareCached(StatementId::GET_ALL_USERS, sql);
+        if (!stmt) {
             return users;
         }
+        StatementReset reset_on_exit(stmt);
 
         while (sqlite3_step(stmt) == SQLITE_ROW) {
             int user_id = sqlite3_column_int(stmt, 0);
@@ -581,7 +1239,6 @@ std::vector<std::shared_ptr<User>> DatabaseHandler::getAllUsers() {
             users.push_back(std::make_shared<User>(user_id, name, email, password_hash));
         }
 
-        sqlite3_finalize(stmt);
 #endif
         return users;
     }
@@ -602,16 +1259,16 @@ std::vector<std::shared_ptr<Account>> DatabaseHandler::getAllAccounts() {
     try {
 #ifdef USE_SQLITE
         const char* sql = "SELECT account_id, user_id, balance, account_type FROM Accounts WHERE is_active = 1";
-        sqlite3_stmt* stmt;
-
-        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        sqlite3_stmt* stmt = prepareCached(StatementId::GET_ALL_ACCOUNTS, sql);
+        if (!stmt) {
             return accounts;
         }
+        StatementReset reset_on_exit(stmt);
 
         while (sqlite3_step(stmt) == SQLITE_ROW) {
             int acc_id = sqlite3_column_int(stmt, 0);
             int user_id = sqlite3_column_int(stmt, 1);
-            double balance = sqlite3_column_double(stmt, 2);
+            Money balance = columnMoney(stmt, 2);
             std::string type_str = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
 
             AccountType type = (type_str == "SAVINGS") ? AccountType::SAVINGS : AccountType::CURRENT;
@@ -619,7 +1276,6 @@ std::vector<std::shared_ptr<Account>> DatabaseHandler::getAllAccounts() {
             accounts.push_back(std::make_shared<Account>(acc_id, user_id, balance, type));
         }
 
-        sqlite3_finalize(stmt);
 #endif
         return accounts;
     }
@@ -633,58 +1289,194 @@ std::vector<std::shared_ptr<Account>> DatabaseHandler::getAllAccounts() {
 bool DatabaseHandler::insertTransaction(const Transaction& transaction) {
     if (!connected) return false;
 
+    return insertTransactionAsync(transaction).get();
+}
+
+// Queue a transaction insert; the future is true once it has committed
+std::future<bool> DatabaseHandler::insertTransactionAsync(const Transaction& transaction) {
+    PendingWrite write;
+    write.kind = PendingWrite::Kind::INSERT_TRANSACTION;
+    write.transaction_id = transaction.getTransactionId();
+    write.from_account_id = transaction.getFromAccountId();
+    write.to_account_id = transaction.getToAccountId();
+    write.amount = transaction.getAmount();
+    write.type = transaction.getTypeString();
+    write.status = transaction.getStatusString();
+    write.description = transaction.getDescription();
+    return enqueueWrite(std::move(write));
+}
+
+// Insert many transactions in one database transaction, reusing one prepared statement.
+// All rows are written or none are.
+bool DatabaseHandler::insertTransactions(const std::vector<std::shared_ptr<Transaction>>& transactions) {
+    if (!connected) return false;
+    if (transactions.empty()) return true;
+
     std::lock_guard<std::mutex> lock(db_mutex);
 
-    try {
 #ifdef USE_SQLITE
-        const char* sql = "INSERT INTO Transactions (from_account_id, to_account_id, amount, transaction_type, status, description) VALUES (?, ?, ?, ?, ?, ?)";
-        sqlite3_stmt* stmt;
+    if (!beginBulkWrite()) {
+        return false;
+    }
+    if (!stepTransactionInserts(transactions)) {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+    return commitBulkWrite();
+#else
+    return false;
+#endif
+}
 
-        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
-            std::cerr << "Failed to prepare insert transaction statement: " << sqlite3_errmsg(db) << std::endl;
-            return false;
-        }
+// Set many account balances in one database transaction, reusing one prepared statement.
+// All balances are written or none are.
+bool DatabaseHandler::updateAccountBalances(const std::vector<std::pair<int, Money>>& balances) {
+    if (!connected) return false;
+    if (balances.empty()) return true;
 
-        // Handle NULL values for from_account_id and to_account_id
-        if (transaction.getFromAccountId() == 0) {
-            sqlite3_bind_null(stmt, 1);
-        } else {
-            sqlite3_bind_int(stmt, 1, transaction.getFromAccountId());
-        }
+    std::lock_guard<std::mutex> lock(db_mutex);
 
-        if (transaction.getToAccountId() == 0) {
-            sqlite3_bind_null(stmt, 2);
-        } else {
-            sqlite3_bind_int(stmt, 2, transaction.getToAccountId());
-        }
+#ifdef USE_SQLITE
+    if (!beginBulkWrite()) {
+        return false;
+    }
+    if (!stepAccountUpdates(balances)) {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+    return commitBulkWrite();
+#else
+    return false;
+#endif
+}
 
-        sqlite3_bind_double(stmt, 3, transaction.getAmount());
-        sqlite3_bind_text(stmt, 4, transaction.getTypeString().c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt, 5, transaction.getStatusString().c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt, 6, transaction.getDescription().c_str(), -1, SQLITE_TRANSIENT);
+// Register the interest run for period, or find the one already started.
+// run_rate is the rate the run was started with; a resumed run must keep using it.
+// resumed is set when an earlier, unfinished run for period exists.
+bool DatabaseHandler::startInterestRun(const std::string& period, double annual_rate, double& run_rate, bool& completed,
+                                       bool& resumed) {
+    if (!connected) return false;
 
-        // Set immediate mode to prevent hanging
-        sqlite3_busy_timeout(db, 0);
+    std::lock_guard<std::mutex> lock(db_mutex);
 
-        int result = sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
+#ifdef USE_SQLITE
+    sqlite3_stmt* stmt;
+    const char* insert_sql = "INSERT OR IGNORE INTO interest_runs (period, annual_rate) VALUES (?, ?)";
+    if (sqlite3_prepare_v2(db, insert_sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Failed to prepare interest run statement: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    sqlite3_bind_text(stmt, 1, period.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_double(stmt, 2, annual_rate);
+    int result = sqlite3_step(stmt);
+    bool inserted = result == SQLITE_DONE && sqlite3_changes(db) > 0;
+    sqlite3_finalize(stmt);
+    if (result != SQLITE_DONE) {
+        std::cerr << "Failed to start interest run: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
 
-        if (result == SQLITE_DONE) {
-            return true;
-        } else if (result == SQLITE_BUSY) {
-            std::cout << "Database busy, transaction recorded in memory only" << std::endl;
-            return true; // Don't fail, just continue with memory-only recording
+    const char* select_sql = "SELECT annual_rate, completed_at IS NOT NULL FROM interest_runs WHERE period = ?";
+    if (sqlite3_prepare_v2(db, select_sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Failed to prepare interest run statement: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    sqlite3_bind_text(stmt, 1, period.c_str(), -1, SQLITE_TRANSIENT);
+    bool found = sqlite3_step(stmt) == SQLITE_ROW;
+    if (found) {
+        run_rate = sqlite3_column_double(stmt, 0);
+        completed = sqlite3_column_int(stmt, 1) != 0;
+        resumed = !inserted && !completed;
+    }
+    sqlite3_finalize(stmt);
+    return found;
+#else
+    (void)period;
+    (void)annual_rate;
+    (void)run_rate;
+    (void)completed;
+    (void)resumed;
+    return false;
+#endif
+}
+
+// Commit one chunk of an interest run: its INTEREST transactions, the new
+// balances and the run's progress counters, all in one database transaction
+bool DatabaseHandler::postInterestChunk(const std::string& period,
+                                        const std::vector<std::shared_ptr<Transaction>>& transactions,
+                                        const std::vector<std::pair<int, Money>>& balances) {
+    if (!connected) return false;
+
+    std::lock_guard<std::mutex> lock(db_mutex);
+
+#ifdef USE_SQLITE
+    Money chunk_interest;
+    for (const auto& transaction : transactions) {
+        chunk_interest += transaction->getAmount();
+    }
+
+    if (!beginBulkWrite()) {
+        return false;
+    }
+
+    bool written = stepTransactionInserts(transactions) && stepAccountUpdates(balances);
+    if (written) {
+        const char* sql = "UPDATE interest_runs SET accounts_posted = accounts_posted + ?, "
+                          "interest_posted = interest_posted + ? WHERE period = ?";
+        sqlite3_stmt* stmt = prepareCached(StatementId::UPDATE_INTEREST_RUN, sql);
+        if (stmt) {
+            StatementReset reset_on_exit(stmt);
+            sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(transactions.size()));
+            bindMoney(stmt, 2, chunk_interest);
+            sqlite3_bind_text(stmt, 3, period.c_str(), -1, SQLITE_STATIC);
+            written = sqlite3_step(stmt) == SQLITE_DONE;
         } else {
-            std::cerr << "Failed to insert transaction: " << sqlite3_errmsg(db) << std::endl;
-            return false;
+            written = false;
+        }
+        if (!written) {
+            std::cerr << "Failed to record interest run progress: " << sqlite3_errmsg(db) << std::endl;
         }
+    }
+
+    if (!written) {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+    return commitBulkWrite();
+#else
+    (void)period;
+    (void)transactions;
+    (void)balances;
+    return false;
 #endif
+}
+
+// Mark the interest run for period as finished
+bool DatabaseHandler::finishInterestRun(const std::string& period) {
+    if (!connected) return false;
+
+    std::lock_guard<std::mutex> lock(db_mutex);
+
+#ifdef USE_SQLITE
+    const char* sql = "UPDATE interest_runs SET completed_at = CURRENT_TIMESTAMP WHERE period = ?";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Failed to prepare interest run statement: " << sqlite3_errmsg(db) << std::endl;
         return false;
     }
-    catch (const std::exception& e) {
-        std::cerr << "Error inserting transaction: " << e.what() << std::endl;
+    sqlite3_bind_text(stmt, 1, period.c_str(), -1, SQLITE_TRANSIENT);
+    int result = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+
+    if (result != SQLITE_DONE) {
+        std::cerr << "Failed to finish interest run: " << sqlite3_errmsg(db) << std::endl;
         return false;
     }
+    return true;
+#else
+    (void)period;
+    return false;
+#endif
 }
 
 // Update transaction
@@ -696,17 +1488,16 @@ bool DatabaseHandler::updateTransaction(const Transaction& transaction) {
     try {
 #ifdef USE_SQLITE
         const char* sql = "UPDATE Transactions SET status = ?, completed_at = CURRENT_TIMESTAMP WHERE transaction_id = ?";
-        sqlite3_stmt* stmt;
-
-        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        sqlite3_stmt* stmt = prepareCached(StatementId::UPDATE_TRANSACTION, sql);
+        if (!stmt) {
             return false;
         }
+        StatementReset reset_on_exit(stmt);
 
         sqlite3_bind_text(stmt, 1, transaction.getStatusString().c_str(), -1, SQLITE_STATIC);
         sqlite3_bind_int(stmt, 2, transaction.getTransactionId());
 
         int result = sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
 
         return result == SQLITE_DONE;
 #endif
@@ -724,49 +1515,33 @@ std::vector<std::shared_ptr<Transaction>> DatabaseHandler::getTransactionsByAcco
 
     if (!connected) return transactions;
 
-    std::lock_guard<std::mutex> lock(db_mutex);
-
     try {
 #ifdef USE_SQLITE
-        const char* sql = "SELECT transaction_id, from_account_id, to_account_id, amount, transaction_type, status, description, created_at FROM Transactions WHERE from_account_id = ? OR to_account_id = ? ORDER BY created_at DESC";
-        sqlite3_stmt* stmt;
+        ReaderLease reader(*this);
+        if (!reader.get()) {
+            return transactions;
+        }
 
-        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        // Two index seeks instead of an OR; the second branch skips rows the first already returned
+        const char* sql =
+            "SELECT transaction_id, from_account_id, to_account_id, amount, transaction_type, status, description, created_at "
+            "FROM Transactions WHERE from_account_id = ?1 "
+            "UNION ALL "
+            "SELECT transaction_id, from_account_id, to_account_id, amount, transaction_type, status, description, created_at "
+            "FROM Transactions WHERE to_account_id = ?1 AND from_account_id IS NOT ?1 "
+            "ORDER BY created_at DESC, transaction_id DESC";
+        sqlite3_stmt* stmt = prepareCached(*reader.get(), StatementId::ACCOUNT_HISTORY, sql);
+        if (!stmt) {
             return transactions;
         }
+        StatementReset reset_on_exit(stmt);
 
         sqlite3_bind_int(stmt, 1, account_id);
-        sqlite3_bind_int(stmt, 2, account_id);
 
         while (sqlite3_step(stmt) == SQLITE_ROW) {
-            int txn_id = sqlite3_column_int(stmt, 0);
-            int from_acc = sqlite3_column_type(stmt, 1) == SQLITE_NULL ? 0 : sqlite3_column_int(stmt, 1);
-            int to_acc = sqlite3_column_type(stmt, 2) == SQLITE_NULL ? 0 : sqlite3_column_int(stmt, 2);
-            double amount = sqlite3_column_double(stmt, 3);
-
-            // Convert string to enum (simplified)
-            std::string type_str = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-            TransactionType type = TransactionType::DEPOSIT;
-            if (type_str == "WITHDRAWAL") type = TransactionType::WITHDRAWAL;
-            else if (type_str == "TRANSFER") type = TransactionType::TRANSFER;
-            else if (type_str == "INTEREST") type = TransactionType::INTEREST;
-
-            std::string status_str = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
-            TransactionStatus status = TransactionStatus::PENDING;
-            if (status_str == "SUCCESS") status = TransactionStatus::SUCCESS;
-            else if (status_str == "FAILED") status = TransactionStatus::FAILED;
-
-            auto transaction = std::make_shared<Transaction>(txn_id, from_acc, to_acc, amount, type, status);
-
-            if (sqlite3_column_type(stmt, 6) != SQLITE_NULL) {
-                std::string desc = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6));
-                transaction->setDescription(desc);
-            }
-
-            transactions.push_back(transaction);
+            transactions.push_back(columnTransaction(stmt));
         }
 
-        sqlite3_finalize(stmt);
 #endif
         return transactions;
     }
@@ -775,3 +1550,87 @@ std::vector<std::shared_ptr<Transaction>> DatabaseHandler::getTransactionsByAcco
         return transactions;
     }
 }
+
+// Get one page of an account's transactions, newest first.
+// Keyset pagination: each page starts strictly after the (created_at, transaction_id)
+// of the previous page's last row, so it reads only about `limit` index entries
+// no matter how deep into the history it is.
+TransactionPage DatabaseHandler::getTransactionsByAccountId(int account_id, int limit, const std::string& cursor) {
+    TransactionPage page;
+
+    if (!connected || limit <= 0) return page;
+
+    std::string cursor_created_at;
+    int cursor_transaction_id = 0;
+    if (!cursor.empty() && !parseHistoryCursor(cursor, cursor_created_at, cursor_transaction_id)) {
+        std::cerr << "Invalid transaction history cursor" << std::endl;
+        return page;
+    }
+
+    try {
+#ifdef USE_SQLITE
+        ReaderLease reader(*this);
+        if (!reader.get()) {
+            return page;
+        }
+
+        // Each branch is a bounded seek on its covering index; only 2 * limit rows are merged
+        const char* first_page_sql =
+            "SELECT * FROM (SELECT transaction_id, from_account_id, to_account_id, amount, transaction_type, status, description, created_at "
+            "FROM Transactions WHERE from_account_id = ?1 "
+            "ORDER BY created_at DESC, transaction_id DESC LIMIT ?2) "
+            "UNION ALL "
+            "SELECT * FROM (SELECT transaction_id, from_account_id, to_account_id, amount, transaction_type, status, description, created_at "
+            "FROM Transactions WHERE to_account_id = ?1 AND from_account_id IS NOT ?1 "
+            "ORDER BY created_at DESC, transaction_id DESC LIMIT ?2) "
+            "ORDER BY created_at DESC, transaction_id DESC LIMIT ?2";
+        const char* next_page_sql =
+            "SELECT * FROM (SELECT transaction_id, from_account_id, to_account_id, amount, transaction_type, status, description, created_at "
+            "FROM Transactions WHERE from_account_id = ?1 AND (created_at, transaction_id) < (?3, ?4) "
+            "ORDER BY created_at DESC, transaction_id DESC LIMIT ?2) "
+            "UNION ALL "
+            "SELECT * FROM (SELECT transaction_id, from_account_id, to_account_id, amount, transaction_type, status, description, created_at "
+            "FROM Transactions WHERE to_account_id = ?1 AND from_account_id IS NOT ?1 AND (created_at, transaction_id) < (?3, ?4) "
+            "ORDER BY created_at DESC, transaction_id DESC LIMIT ?2) "
+            "ORDER BY created_at DESC, transaction_id DESC LIMIT ?2";
+        sqlite3_stmt* stmt = cursor.empty() ? prepareCached(*reader.get(), StatementId::HISTORY_FIRST_PAGE, first_page_sql)
+                                            : prepareCached(*reader.get(), StatementId::HISTORY_NEXT_PAGE, next_page_sql);
+        if (!stmt) {
+            std::cerr << "Failed to prepare transaction page statement: " << sqlite3_errmsg(reader.get()->handle) << std::endl;
+            return page;
+        }
+        StatementReset reset_on_exit(stmt);
+
+        // One extra row tells us whether another page exists
+        sqlite3_bind_int(stmt, 1, account_id);
+        sqlite3_bind_int(stmt, 2, limit + 1);
+        if (!cursor.empty()) {
+            sqlite3_bind_text(stmt, 3, cursor_created_at.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_int(stmt, 4, cursor_transaction_id);
+        }
+
+        page.transactions.reserve(limit);
+        bool has_more = false;
+        std::string last_created_at;
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            if (static_cast<int>(page.transactions.size()) == limit) {
+                has_more = true;
+                break;
+            }
+            page.transactions.push_back(columnTransaction(stmt));
+            last_created_at = page.transactions.back()->getTimestamp();
+        }
+
+        if (has_more) {
+            page.next_cursor = makeHistoryCursor(last_created_at, page.transactions.back()->getTransactionId());
+        }
+#else
+        (void)account_id;
+#endif
+        return page;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error getting transaction page: " << e.what() << std::endl;
+        return page;
+    }
+}
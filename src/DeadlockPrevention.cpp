@@ -3,338 +3,612 @@
 #include <algorithm>
 #include <thread>
 
+// Transaction used by the account-list overloads of requestLocks/releaseLocks
+static thread_local TransactionHandle implicit_transaction;
+
 // Constructor
 DeadlockPrevention::DeadlockPrevention(DeadlockStrategy strategy)
-    : strategy(strategy), lock_timeout(std::chrono::milliseconds(5000)),
+    : strategy(strategy),
+      stripes(new LockStripe[BankingConstants::LOCK_TABLE_STRIPES]),
+      stripe_count(BankingConstants::LOCK_TABLE_STRIPES),
+      slab_chunks(new std::atomic<TransactionSlot*>[SLAB_MAX_CHUNKS]),
+      slab_chunk_count(0), free_head(0), walk_stamp(0), detector_stopping(false),
+      lock_timeout(std::chrono::milliseconds(5000)),
       deadlock_check_interval(std::chrono::milliseconds(100)),
-      deadlocks_detected(0), deadlocks_prevented(0), transactions_aborted(0) {}
+      deadlocks_detected(0), deadlocks_prevented(0), transactions_aborted(0),
+      lock_waits(0), lock_wait_micros(0), deadlock_victims(0), detection_latency_micros(0),
+      max_detection_latency_micros(0), optimistic_commits(0), optimistic_conflicts(0) {
+    for (uint32_t i = 0; i < SLAB_MAX_CHUNKS; i++) {
+        slab_chunks[i] = nullptr;
+    }
+}
 
 // Destructor
-DeadlockPrevention::~DeadlockPrevention() {}
+DeadlockPrevention::~DeadlockPrevention() {
+    stopDetector();
+    for (uint32_t i = 0; i < slab_chunk_count; i++) {
+        delete[] slab_chunks[i].load();
+    }
+}
+
+// Start a transaction: take a slot from the free list, growing the slab if it is empty
+TransactionHandle DeadlockPrevention::beginTransaction(int transaction_id) {
+    uint32_t index = TransactionHandle::NO_SLOT;
+
+    uint64_t head = free_head.load();
+    while (static_cast<uint32_t>(head) != 0) {
+        uint32_t top = static_cast<uint32_t>(head) - 1;
+        uint64_t next = (((head >> 32) + 1) << 32) | slotAt(top).next_free.load();
+        if (free_head.compare_exchange_weak(head, next)) {
+            index = top;
+            break;
+        }
+    }
+
+    if (index == TransactionHandle::NO_SLOT) {
+        std::lock_guard<std::mutex> lock(slab_grow_mutex);
+        uint32_t chunk = slab_chunk_count;
+        if (chunk == SLAB_MAX_CHUNKS) {
+            std::cerr << "Lock manager transaction slab is full" << std::endl;
+            return TransactionHandle();
+        }
+
+        // Keep the first slot of the new chunk and chain the rest onto the free list
+        TransactionSlot* slots = new TransactionSlot[SLAB_CHUNK_SIZE];
+        uint32_t first = chunk * SLAB_CHUNK_SIZE;
+        for (uint32_t i = 1; i + 1 < SLAB_CHUNK_SIZE; i++) {
+            slots[i].next_free = first + i + 2;
+        }
+        slab_chunks[chunk].store(slots);
+        slab_chunk_count = chunk + 1;
+
+        uint64_t current = free_head.load();
+        uint64_t next;
+        do {
+            slots[SLAB_CHUNK_SIZE - 1].next_free = static_cast<uint32_t>(current);
+            next = (((current >> 32) + 1) << 32) | (first + 2);
+        } while (!free_head.compare_exchange_weak(current, next));
+        index = first;
+    }
+
+    TransactionHandle transaction;
+    transaction.slot = index;
+    transaction.generation = static_cast<uint32_t>(slotAt(index).state.load() >> 1);
+    transaction.transaction_id = transaction_id;
+    transaction.start = std::chrono::steady_clock::now();
+    return transaction;
+}
+
+// Finish a transaction: retire its generation and return the slot
+void DeadlockPrevention::endTransaction(TransactionHandle& transaction) {
+    if (!transaction.isValid()) {
+        return;
+    }
+
+    TransactionSlot& slot = slotAt(transaction.slot);
+    slot.state = static_cast<uint64_t>(transaction.generation + 1) << 1; // Also clears a wound
+
+    uint64_t head = free_head.load();
+    uint64_t next;
+    do {
+        slot.next_free = static_cast<uint32_t>(head);
+        next = (((head >> 32) + 1) << 32) | (transaction.slot + 1);
+    } while (!free_head.compare_exchange_weak(head, next));
+
+    transaction = TransactionHandle();
+}
 
 // Request locks with deadlock prevention
-bool DeadlockPrevention::requestLocks(const std::vector<int>& account_ids, int transaction_id) {
-    registerThread(transaction_id);
-    
+bool DeadlockPrevention::requestLocks(const TransactionHandle& transaction, const std::vector<int>& account_ids) {
+    if (!transaction.isValid()) {
+        return false;
+    }
+
     switch (strategy) {
         case DeadlockStrategy::LOCK_ORDERING:
-            return lockOrderingStrategy(account_ids, transaction_id);
+            return lockOrderingStrategy(transaction, account_ids);
         case DeadlockStrategy::WAIT_DIE:
-            return waitDieStrategy(account_ids, transaction_id);
+            return waitDieStrategy(transaction, account_ids);
         case DeadlockStrategy::WOUND_WAIT:
-            return woundWaitStrategy(account_ids, transaction_id);
+            return woundWaitStrategy(transaction, account_ids);
         case DeadlockStrategy::TIMEOUT_ROLLBACK:
-            return timeoutRollbackStrategy(account_ids, transaction_id);
+            return timeoutRollbackStrategy(transaction, account_ids);
+        case DeadlockStrategy::OPTIMISTIC: // Optimistic transfers never get here; other callers still lock in order
         default:
-            return lockOrderingStrategy(account_ids, transaction_id);
+            return lockOrderingStrategy(transaction, account_ids);
     }
 }
 
 // Release locks for specific accounts
-void DeadlockPrevention::releaseLocks(const std::vector<int>& account_ids) {
-    std::lock_guard<std::mutex> lock(wait_graph_mutex);
-
-    size_t thread_hash = getThreadHash();
+void DeadlockPrevention::releaseLocks(const TransactionHandle& transaction, const std::vector<int>& account_ids) {
+    for (int account_id : account_ids) {
+        releaseAccount(transaction, account_id);
+    }
+}
 
-    // Remove from thread_locks
-    if (thread_locks.find(thread_hash) != thread_locks.end()) {
-        for (int account_id : account_ids) {
-            thread_locks[thread_hash].erase(account_id);
-            account_owners.erase(account_id);
+// Release all locks a transaction holds
+void DeadlockPrevention::releaseAllLocks(const TransactionHandle& transaction) {
+    // One stripe at a time
+    for (size_t i = 0; i < stripe_count; i++) {
+        std::lock_guard<std::mutex> lock(stripes[i].mutex);
+        auto& locks = stripes[i].locks;
+        for (auto it = locks.begin(); it != locks.end();) {
+            if (it->second.owner == transaction && !handOff(it->second)) {
+                it = locks.erase(it);
+            } else {
+                ++it;
+            }
         }
+    }
+}
 
-        if (thread_locks[thread_hash].empty()) {
-            thread_locks.erase(thread_hash);
-        }
+// Request locks for the calling thread's implicit transaction
+bool DeadlockPrevention::requestLocks(const std::vector<int>& account_ids, int transaction_id) {
+    bool started = !implicit_transaction.isValid();
+    if (started) {
+        implicit_transaction = beginTransaction(transaction_id);
     }
 
-    // Remove from waiting requests
-    waiting_requests.erase(thread_hash);
+    bool acquired = requestLocks(implicit_transaction, account_ids);
+    if (!acquired && started) {
+        endTransaction(implicit_transaction);
+    }
+    return acquired;
 }
 
-// Release all locks for current thread
-void DeadlockPrevention::releaseAllLocks() {
-    std::lock_guard<std::mutex> lock(wait_graph_mutex);
+// Release locks and end the calling thread's implicit transaction
+void DeadlockPrevention::releaseLocks(const std::vector<int>& account_ids) {
+    if (implicit_transaction.isValid()) {
+        releaseLocks(implicit_transaction, account_ids);
+        endTransaction(implicit_transaction);
+    }
+}
 
-    size_t thread_hash = getThreadHash();
+// Stripe holding an account's lock entry
+size_t DeadlockPrevention::stripeIndex(int account_id) const {
+    // Fibonacci hashing spreads neighbouring ids across stripes
+    uint64_t hash = static_cast<uint64_t>(static_cast<uint32_t>(account_id)) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<size_t>(hash >> 32) % stripe_count;
+}
 
-    // Remove all locks held by this thread
-    if (thread_locks.find(thread_hash) != thread_locks.end()) {
-        for (int account_id : thread_locks[thread_hash]) {
-            account_owners.erase(account_id);
-        }
-        thread_locks.erase(thread_hash);
-    }
+DeadlockPrevention::LockStripe& DeadlockPrevention::stripeFor(int account_id) const {
+    return stripes[stripeIndex(account_id)];
+}
 
-    // Remove from waiting requests
-    waiting_requests.erase(thread_hash);
+// Slab slot by index
+DeadlockPrevention::TransactionSlot& DeadlockPrevention::slotAt(uint32_t slot) const {
+    return slab_chunks[slot / SLAB_CHUNK_SIZE].load()[slot % SLAB_CHUNK_SIZE];
+}
 
-    // Unregister thread
-    unregisterThread();
+// Whether the handle's transaction is still running
+bool DeadlockPrevention::isCurrent(const TransactionHandle& transaction) const {
+    return transaction.isValid() && (slotAt(transaction.slot).state.load() >> 1) == transaction.generation;
 }
 
-// Get thread hash (simplified version)
-size_t DeadlockPrevention::getThreadHash() const {
-    // Simple hash based on thread id address (for demonstration)
-    auto tid = std::this_thread::get_id();
-    return reinterpret_cast<size_t>(&tid) % 1000000;
+bool DeadlockPrevention::isWounded(const TransactionHandle& transaction) const {
+    return slotAt(transaction.slot).state.load() == ((static_cast<uint64_t>(transaction.generation) << 1) | 1);
 }
 
 // Lock ordering strategy (prevent deadlock by ordering)
-bool DeadlockPrevention::lockOrderingStrategy(const std::vector<int>& account_ids, int transaction_id) {
-    (void)transaction_id; // Suppress unused parameter warning
-
+bool DeadlockPrevention::lockOrderingStrategy(const TransactionHandle& transaction,
+                                              const std::vector<int>& account_ids) {
     // Sort account IDs to ensure consistent locking order
     std::vector<int> sorted_ids = account_ids;
     std::sort(sorted_ids.begin(), sorted_ids.end());
 
-    std::lock_guard<std::mutex> lock(wait_graph_mutex);
-
-    size_t thread_hash = getThreadHash();
-
-    // Check if all accounts are available
-    for (int account_id : sorted_ids) {
-        if (account_owners.find(account_id) != account_owners.end() &&
-            account_owners[account_id] != thread_hash) {
-            return false; // Account is locked by another thread
-        }
-    }
-
-    // Acquire all locks
-    for (int account_id : sorted_ids) {
-        account_owners[account_id] = thread_hash;
-        thread_locks[thread_hash].insert(account_id);
+    if (!acquireAll(transaction, sorted_ids, DeadlockStrategy::LOCK_ORDERING)) {
+        return false;
     }
 
     deadlocks_prevented++;
     return true;
 }
 
-// Wait-Die strategy
-bool DeadlockPrevention::waitDieStrategy(const std::vector<int>& account_ids, int transaction_id) {
-    std::lock_guard<std::mutex> lock(wait_graph_mutex);
+// Wait-Die strategy: an older transaction waits for a younger holder, a younger one dies
+bool DeadlockPrevention::waitDieStrategy(const TransactionHandle& transaction, const std::vector<int>& account_ids) {
+    return acquireAll(transaction, account_ids, DeadlockStrategy::WAIT_DIE);
+}
+
+// Wound-Wait strategy: an older transaction wounds a younger holder, a younger one waits
+bool DeadlockPrevention::woundWaitStrategy(const TransactionHandle& transaction,
+                                           const std::vector<int>& account_ids) {
+    return acquireAll(transaction, account_ids, DeadlockStrategy::WOUND_WAIT);
+}
+
+// Timeout rollback strategy: wait in the given order and give up at lock_timeout
+bool DeadlockPrevention::timeoutRollbackStrategy(const TransactionHandle& transaction,
+                                                 const std::vector<int>& account_ids) {
+    return acquireAll(transaction, account_ids, DeadlockStrategy::TIMEOUT_ROLLBACK);
+}
 
-    size_t thread_hash = getThreadHash();
+// Acquire accounts in order, waiting for each; on failure release what was taken
+bool DeadlockPrevention::acquireAll(const TransactionHandle& transaction, const std::vector<int>& account_ids,
+                                    DeadlockStrategy policy) {
+    auto deadline = std::chrono::steady_clock::now() + lock_timeout;
 
-    // Check if any required account is locked
+    std::vector<int> acquired;
+    acquired.reserve(account_ids.size());
+    AcquireResult result = AcquireResult::GRANTED;
     for (int account_id : account_ids) {
-        if (account_owners.find(account_id) != account_owners.end()) {
-            auto owner_thread = account_owners[account_id];
-
-            if (owner_thread != thread_hash) {
-                // If this transaction is older, wait; if younger, die
-                if (isOlderTransaction(thread_hash, owner_thread)) {
-                    // Wait - add to waiting list
-                    for (int acc_id : account_ids) {
-                        waiting_requests[thread_hash].emplace_back(thread_hash, acc_id, transaction_id);
-                    }
-                    return false;
-                } else {
-                    // Die - abort this transaction
-                    transactions_aborted++;
-                    return false;
-                }
-            }
+        result = acquireAccount(transaction, account_id, policy, deadline);
+        if (result != AcquireResult::GRANTED) {
+            break;
         }
+        acquired.push_back(account_id);
     }
 
-    // All accounts available, acquire locks
-    for (int account_id : account_ids) {
-        account_owners[account_id] = thread_hash;
-        thread_locks[thread_hash].insert(account_id);
+    if (result == AcquireResult::GRANTED) {
+        return true;
     }
 
-    return true;
+    for (int account_id : acquired) {
+        releaseAccount(transaction, account_id);
+    }
+    transactions_aborted++;
+    return false;
 }
 
-// Wound-Wait strategy
-bool DeadlockPrevention::woundWaitStrategy(const std::vector<int>& account_ids, int transaction_id) {
-    (void)transaction_id; // Suppress unused parameter warning
+// Take one account, queueing behind its holder if the policy says to wait.
+// Only this account's stripe is locked, and never while parked.
+DeadlockPrevention::AcquireResult DeadlockPrevention::acquireAccount(
+    const TransactionHandle& transaction, int account_id, DeadlockStrategy policy,
+    std::chrono::steady_clock::time_point deadline) {
+    LockStripe& stripe = stripeFor(account_id);
+    std::unique_lock<std::mutex> stripe_lock(stripe.mutex);
+
+    auto it = stripe.locks.find(account_id);
+    if (it == stripe.locks.end()) {
+        stripe.locks.emplace(account_id, AccountLock{transaction, {}});
+        return AcquireResult::GRANTED;
+    }
+    if (it->second.owner == transaction) {
+        return AcquireResult::GRANTED;
+    }
 
-    std::lock_guard<std::mutex> lock(wait_graph_mutex);
+    bool older = transaction.isOlderThan(it->second.owner);
+    ConflictAction action = ConflictAction::WAIT;
+    if (policy == DeadlockStrategy::WAIT_DIE && !older) {
+        action = ConflictAction::DIE;
+    } else if (policy == DeadlockStrategy::WOUND_WAIT && older) {
+        action = ConflictAction::WOUND;
+    }
+    if (action == ConflictAction::DIE) {
+        return AcquireResult::DIED;
+    }
 
-    size_t thread_hash = getThreadHash();
+    // Park at the back of the queue; the holder hands the account over on release
+    LockWaiter waiter(transaction, policy);
+    TransactionHandle holder = it->second.owner;
+    it->second.waiters.push_back(&waiter);
+    addToWaitGraph(transaction, account_id, holder, &waiter);
+    stripe_lock.unlock();
 
-    // Check if any required account is locked
-    for (int account_id : account_ids) {
-        if (account_owners.find(account_id) != account_owners.end()) {
-            auto owner_thread = account_owners[account_id];
-
-            if (owner_thread != thread_hash) {
-                if (isOlderTransaction(thread_hash, owner_thread)) {
-                    // Wound the younger transaction
-                    abortTransaction(owner_thread);
-                } else {
-                    // Wait
-                    for (int acc_id : account_ids) {
-                        waiting_requests[thread_hash].emplace_back(thread_hash, acc_id, transaction_id);
-                    }
-                    return false;
-                }
-            }
+    if (action == ConflictAction::WOUND) {
+        abortTransaction(holder); // Gives up if it is waiting; otherwise we wait for its release
+    }
+
+    auto wait_start = std::chrono::steady_clock::now();
+    {
+        std::unique_lock<std::mutex> wait_lock(waiter.mutex);
+        waiter.cv.wait_until(wait_lock, deadline, [&waiter]() { return waiter.granted || waiter.aborted; });
+    }
+    lock_waits++;
+    lock_wait_micros += std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - wait_start).count();
+
+    // Settle under the stripe: a hand-over can race with the timeout or a wound
+    stripe_lock.lock();
+    removeFromWaitGraph(transaction); // Already gone if the account was handed over
+    bool granted;
+    bool aborted;
+    {
+        std::lock_guard<std::mutex> wait_lock(waiter.mutex);
+        granted = waiter.granted;
+        aborted = waiter.aborted;
+    }
+
+    if (granted) {
+        if (!aborted) {
+            return AcquireResult::GRANTED;
         }
+        stripe_lock.unlock();
+        releaseAccount(transaction, account_id);
+        return AcquireResult::ABORTED;
     }
 
-    // Acquire locks
-    for (int account_id : account_ids) {
-        account_owners[account_id] = thread_hash;
-        thread_locks[thread_hash].insert(account_id);
+    // A waiter that died in handOff has already left the queue
+    auto lock_it = stripe.locks.find(account_id);
+    if (lock_it != stripe.locks.end()) {
+        auto& waiters = lock_it->second.waiters;
+        auto queued = std::find(waiters.begin(), waiters.end(), &waiter);
+        if (queued != waiters.end()) {
+            waiters.erase(queued);
+        }
     }
+    return aborted ? AcquireResult::ABORTED : AcquireResult::TIMED_OUT;
+}
 
-    return true;
+// Give an account back, handing it to the next waiter if there is one
+void DeadlockPrevention::releaseAccount(const TransactionHandle& transaction, int account_id) {
+    LockStripe& stripe = stripeFor(account_id);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+
+    auto it = stripe.locks.find(account_id);
+    if (it != stripe.locks.end() && it->second.owner == transaction && !handOff(it->second)) {
+        stripe.locks.erase(it);
+    }
 }
 
-// Timeout rollback strategy
-bool DeadlockPrevention::timeoutRollbackStrategy(const std::vector<int>& account_ids, int transaction_id) {
-    auto start_time = std::chrono::steady_clock::now();
-    
-    while (std::chrono::steady_clock::now() - start_time < lock_timeout) {
-        {
-            std::lock_guard<std::mutex> lock(wait_graph_mutex);
-            
-            // Try to acquire all locks
-            if (tryLockAccounts(account_ids)) {
-                size_t thread_hash = getThreadHash();
-                for (int account_id : account_ids) {
-                    account_owners[account_id] = thread_hash;
-                    thread_locks[thread_hash].insert(account_id);
-                }
-                return true;
+// Make the oldest waiter the holder and wake exactly that thread
+bool DeadlockPrevention::handOff(AccountLock& lock) {
+    if (lock.waiters.empty()) {
+        return false;
+    }
+
+    LockWaiter* next = lock.waiters.front();
+    lock.waiters.pop_front();
+    lock.owner = next->owner;
+
+    // The new holder stops waiting and everyone behind it now waits for it.
+    // Each waiter's policy was checked against the old holder only, so apply it
+    // again: under wait-die a waiter younger than the new holder dies, under
+    // wound-wait an older waiter wounds the new holder.
+    {
+        std::lock_guard<std::mutex> graph_lock(wait_graph_mutex);
+        eraseWaitEdge(next->owner.slot);
+        auto now = std::chrono::steady_clock::now();
+        bool wound_owner = false;
+        for (auto it = lock.waiters.begin(); it != lock.waiters.end();) {
+            LockWaiter* waiter = *it;
+            bool older = waiter->owner.isOlderThan(lock.owner);
+            if (waiter->policy == DeadlockStrategy::WAIT_DIE && !older) {
+                eraseWaitEdge(waiter->owner.slot);
+                std::lock_guard<std::mutex> wait_lock(waiter->mutex);
+                waiter->aborted = true;
+                waiter->cv.notify_one();
+                it = lock.waiters.erase(it);
+                continue;
             }
+            if (waiter->policy == DeadlockStrategy::WOUND_WAIT && older) {
+                wound_owner = true;
+            }
+
+            TransactionSlot& slot = slotAt(waiter->owner.slot);
+            if (slot.waiting && slot.request.requester == waiter->owner) {
+                slot.request.blocked_by = lock.owner;
+                slot.edge_since = now;
+            }
+            ++it;
+        }
+        if (wound_owner) {
+            woundTransaction(lock.owner); // It gives up at its next wait; until then the waiter queues
         }
-        
-        // Wait before retrying
-        std::this_thread::sleep_for(deadlock_check_interval);
     }
-    
-    // Timeout reached
-    transactions_aborted++;
-    return false;
+
+    std::lock_guard<std::mutex> wait_lock(next->mutex);
+    next->granted = true;
+    next->cv.notify_one(); // Under the mutex: the waiter's frame may go once it wakes
+    return true;
 }
 
 // Detect deadlock
 bool DeadlockPrevention::detectDeadlock() {
-    std::lock_guard<std::mutex> lock(wait_graph_mutex);
     return hasCycle();
 }
 
-// Resolve deadlock
+// Resolve deadlock: abort the youngest transaction of each cycle and wake it.
+// Its acquireAll gives back what it holds, which lets the rest of the cycle run.
 bool DeadlockPrevention::resolveDeadlock() {
-    auto cycle = findDeadlockCycle();
-    if (!cycle.empty()) {
-        // Abort the youngest transaction in the cycle
-        auto youngest = *std::max_element(cycle.begin(), cycle.end(),
-            [this](const auto& a, const auto& b) {
-                return isOlderTransaction(a, b);
-            });
-        
-        abortTransaction(youngest);
+    std::lock_guard<std::mutex> lock(wait_graph_mutex);
+    auto now = std::chrono::steady_clock::now();
+
+    bool resolved = false;
+    for (const auto& cycle : findCycles(false)) {
+        uint32_t victim = cycle.front();
+        auto closed = slotAt(victim).edge_since;
+        bool already_aborted = false;
+        for (uint32_t slot : cycle) {
+            const TransactionSlot& member = slotAt(slot);
+            if (isWounded(member.request.requester)) {
+                already_aborted = true; // Being resolved; its waiter just has not left yet
+                break;
+            }
+            if (slotAt(victim).request.requester.isOlderThan(member.request.requester)) {
+                victim = slot;
+            }
+            closed = std::max(closed, member.edge_since);
+        }
+        if (already_aborted || !woundTransaction(slotAt(victim).request.requester)) {
+            continue;
+        }
+
+        uint64_t latency = std::chrono::duration_cast<std::chrono::microseconds>(now - closed).count();
+        detection_latency_micros += latency;
+        uint64_t max_latency = max_detection_latency_micros;
+        while (latency > max_latency && !max_detection_latency_micros.compare_exchange_weak(max_latency, latency)) {
+        }
         deadlocks_detected++;
-        return true;
+        deadlock_victims++;
+        resolved = true;
     }
-    return false;
+    return resolved;
 }
 
-// Find deadlock cycle
-std::vector<size_t> DeadlockPrevention::findDeadlockCycle() {
-    std::unordered_set<size_t> visited;
-    std::unordered_set<size_t> recursion_stack;
+// Find deadlock cycle: the transactions on one cycle, in wait-for order
+std::vector<TransactionHandle> DeadlockPrevention::findDeadlockCycle() {
+    std::lock_guard<std::mutex> lock(wait_graph_mutex);
 
-    for (const auto& [thread_hash, locks] : thread_locks) {
-        if (visited.find(thread_hash) == visited.end()) {
-            if (dfsHasCycle(thread_hash, visited, recursion_stack)) {
-                // Return the cycle (simplified - return all threads in recursion stack)
-                std::vector<size_t> cycle;
-                for (const auto& tid : recursion_stack) {
-                    cycle.push_back(tid);
-                }
-                return cycle;
-            }
+    std::vector<TransactionHandle> cycle;
+    for (const auto& found : findCycles(true)) {
+        for (uint32_t slot : found) {
+            cycle.push_back(slotAt(slot).request.requester);
         }
     }
-
-    return {};
+    return cycle;
 }
 
-// Register thread with timestamp
-void DeadlockPrevention::registerThread(int transaction_id) {
-    std::lock_guard<std::mutex> lock(wait_graph_mutex);
-    thread_timestamps[getThreadHash()] = transaction_id;
+// Start the background detector
+bool DeadlockPrevention::startDetector() {
+    std::lock_guard<std::mutex> lock(detector_mutex);
+    if (detector_thread.joinable()) {
+        return false;
+    }
+
+    detector_stopping = false;
+    detector_thread = std::thread(&DeadlockPrevention::detectorLoop, this);
+    return true;
 }
 
-// Unregister thread
-void DeadlockPrevention::unregisterThread() {
-    std::lock_guard<std::mutex> lock(wait_graph_mutex);
-    size_t thread_hash = getThreadHash();
-    thread_timestamps.erase(thread_hash);
-    thread_locks.erase(thread_hash);
-    waiting_requests.erase(thread_hash);
+// Stop the background detector and wait for it to exit
+void DeadlockPrevention::stopDetector() {
+    std::thread stopping;
+    {
+        std::lock_guard<std::mutex> lock(detector_mutex);
+        detector_stopping = true;
+        stopping = std::move(detector_thread);
+    }
+    detector_cv.notify_all();
+    if (stopping.joinable()) {
+        stopping.join();
+    }
 }
 
-// Get thread timestamp
-int DeadlockPrevention::getThreadTimestamp(size_t thread_hash) const {
-    auto it = thread_timestamps.find(thread_hash);
-    return (it != thread_timestamps.end()) ? it->second : 0;
+bool DeadlockPrevention::isDetectorRunning() const {
+    std::lock_guard<std::mutex> lock(detector_mutex);
+    return detector_thread.joinable();
 }
 
-// Check if transaction is older
-bool DeadlockPrevention::isOlderTransaction(size_t t1, size_t t2) const {
-    return getThreadTimestamp(t1) < getThreadTimestamp(t2);
+// Set how often the detector looks for cycles
+void DeadlockPrevention::setCheckInterval(std::chrono::milliseconds interval) {
+    {
+        std::lock_guard<std::mutex> lock(detector_mutex);
+        deadlock_check_interval = interval;
+    }
+    detector_cv.notify_all();
 }
 
-// Try to lock accounts
-bool DeadlockPrevention::tryLockAccounts(const std::vector<int>& account_ids) {
-    for (int account_id : account_ids) {
-        if (account_owners.find(account_id) != account_owners.end()) {
-            return false;
+// Detector thread main loop
+void DeadlockPrevention::detectorLoop() {
+    std::unique_lock<std::mutex> lock(detector_mutex);
+    while (!detector_stopping) {
+        detector_cv.wait_for(lock, deadlock_check_interval);
+        if (detector_stopping) {
+            break;
         }
+
+        lock.unlock();
+        resolveDeadlock();
+        lock.lock();
     }
-    return true;
 }
 
-// Abort transaction
-void DeadlockPrevention::abortTransaction(size_t thread_hash) {
-    // Release all locks held by this thread
-    if (thread_locks.find(thread_hash) != thread_locks.end()) {
-        for (int account_id : thread_locks[thread_hash]) {
-            account_owners.erase(account_id);
-        }
-        thread_locks.erase(thread_hash);
+// Record that a transaction is parked on account_id, which holder has
+void DeadlockPrevention::addToWaitGraph(const TransactionHandle& waiter, int account_id,
+                                        const TransactionHandle& holder, LockWaiter* parked) {
+    std::lock_guard<std::mutex> lock(wait_graph_mutex);
+    TransactionSlot& slot = slotAt(waiter.slot);
+    slot.request = LockRequest(waiter, account_id, holder, parked);
+    slot.edge_since = slot.request.request_time;
+    slot.waiting = true;
+    slot.waiting_index = waiting_slots.size();
+    waiting_slots.push_back(waiter.slot);
+
+    if (isWounded(waiter)) {
+        std::lock_guard<std::mutex> wait_lock(parked->mutex);
+        parked->aborted = true; // Wounded before it parked
     }
+}
 
-    waiting_requests.erase(thread_hash);
-    transactions_aborted++;
+// Forget what a transaction was waiting for
+void DeadlockPrevention::removeFromWaitGraph(const TransactionHandle& waiter) {
+    std::lock_guard<std::mutex> lock(wait_graph_mutex);
+    eraseWaitEdge(waiter.slot);
 }
 
-// DFS cycle detection
-bool DeadlockPrevention::dfsHasCycle(size_t current,
-                                   std::unordered_set<size_t>& visited,
-                                   std::unordered_set<size_t>& recursion_stack) const {
-    visited.insert(current);
-    recursion_stack.insert(current);
+void DeadlockPrevention::eraseWaitEdge(uint32_t slot) {
+    TransactionSlot& entry = slotAt(slot);
+    if (!entry.waiting) {
+        return;
+    }
 
-    // Check all threads this thread is waiting for
-    if (waiting_requests.find(current) != waiting_requests.end()) {
-        for (const auto& request : waiting_requests.at(current)) {
-            auto owner_it = account_owners.find(request.account_id);
-            if (owner_it != account_owners.end()) {
-                auto owner_thread = owner_it->second;
+    // Swap-remove from waiting_slots
+    uint32_t moved = waiting_slots.back();
+    waiting_slots[entry.waiting_index] = moved;
+    slotAt(moved).waiting_index = entry.waiting_index;
+    waiting_slots.pop_back();
 
-                if (recursion_stack.find(owner_thread) != recursion_stack.end()) {
-                    return true; // Cycle detected
-                }
+    entry.waiting = false;
+    entry.request.waiter = nullptr;
+}
+
+// Abort transaction: wake it if it is parked, otherwise make its next wait fail.
+// It releases its own locks as it gives up.
+void DeadlockPrevention::abortTransaction(const TransactionHandle& transaction) {
+    std::lock_guard<std::mutex> lock(wait_graph_mutex);
+    woundTransaction(transaction);
+}
+
+bool DeadlockPrevention::woundTransaction(const TransactionHandle& transaction) {
+    TransactionSlot& slot = slotAt(transaction.slot);
+    uint64_t running = static_cast<uint64_t>(transaction.generation) << 1;
+    if (!slot.state.compare_exchange_strong(running, running | 1)) {
+        return false;
+    }
 
-                if (visited.find(owner_thread) == visited.end()) {
-                    if (dfsHasCycle(owner_thread, visited, recursion_stack)) {
-                        return true;
-                    }
+    if (slot.waiting && slot.request.requester == transaction && slot.request.waiter) {
+        std::lock_guard<std::mutex> wait_lock(slot.request.waiter->mutex);
+        slot.request.waiter->aborted = true;
+        slot.request.waiter->cv.notify_one();
+    }
+    return true;
+}
+
+// The waiting transaction that slot is blocked by, if that one is waiting too
+bool DeadlockPrevention::nextWaiter(uint32_t slot, uint32_t& next) const {
+    const TransactionHandle& holder = slotAt(slot).request.blocked_by;
+    const TransactionSlot& target = slotAt(holder.slot);
+    if (!target.waiting || target.request.requester != holder) {
+        return false;
+    }
+    next = holder.slot;
+    return true;
+}
+
+// Cycles in the wait-for graph. Each waiter has one outgoing edge, so a walk
+// from it either ends, runs into an earlier walk, or comes back to a slot it
+// already stamped, which starts a cycle. Every slot is visited once.
+std::vector<std::vector<uint32_t>> DeadlockPrevention::findCycles(bool first_only) const {
+    std::vector<std::vector<uint32_t>> cycles;
+    uint64_t search_start = walk_stamp + 1;
+
+    for (uint32_t start : waiting_slots) {
+        uint64_t stamp = ++walk_stamp;
+        uint32_t current = start;
+        while (true) {
+            TransactionSlot& slot = slotAt(current);
+            if (slot.walk_stamp >= search_start) {
+                if (slot.walk_stamp == stamp) {
+                    std::vector<uint32_t> cycle;
+                    uint32_t member = current;
+                    do {
+                        cycle.push_back(member);
+                        nextWaiter(member, member);
+                    } while (member != current);
+                    cycles.push_back(std::move(cycle));
                 }
+                break;
+            }
+            slot.walk_stamp = stamp;
+            if (!nextWaiter(current, current)) {
+                break;
             }
         }
-    }
 
-    recursion_stack.erase(current);
-    return false;
+        if (first_only && !cycles.empty()) {
+            break;
+        }
+    }
+    return cycles;
 }
 
 // Display statistics
@@ -354,27 +628,41 @@ void DeadlockPrevention::displayStatistics() const {
         case DeadlockStrategy::TIMEOUT_ROLLBACK:
             std::cout << "Timeout Rollback" << std::endl;
             break;
+        case DeadlockStrategy::OPTIMISTIC:
+            std::cout << "Optimistic" << std::endl;
+            break;
+    }
+    std::cout << "Lock Table Stripes: " << stripe_count << std::endl;
+    std::cout << "Transaction Slots: " << slab_chunk_count * SLAB_CHUNK_SIZE << std::endl;
+    std::cout << "Deadlock Detector: " << (isDetectorRunning() ? "Running" : "Stopped") << std::endl;
+    std::cout << "Deadlocks Detected: " << deadlocks_detected;
+    uint64_t victims = deadlock_victims;
+    if (victims > 0) {
+        std::cout << " (detection latency average " << (detection_latency_micros / victims)
+                  << " us, max " << max_detection_latency_micros << " us)";
     }
-    std::cout << "Deadlocks Detected: " << deadlocks_detected << std::endl;
+    std::cout << std::endl;
+    std::cout << "Deadlock Victims: " << victims << std::endl;
     std::cout << "Deadlocks Prevented: " << deadlocks_prevented << std::endl;
     std::cout << "Transactions Aborted: " << transactions_aborted << std::endl;
+    uint64_t commits = optimistic_commits;
+    uint64_t conflicts = optimistic_conflicts;
+    if (commits > 0 || conflicts > 0) {
+        std::cout << "Optimistic Commits: " << commits << " (" << conflicts << " conflicts)" << std::endl;
+    }
+    uint64_t waits = lock_waits;
+    std::cout << "Lock Waits: " << waits;
+    if (waits > 0) {
+        std::cout << " (average " << (lock_wait_micros / waits) << " us)";
+    }
+    std::cout << std::endl;
     std::cout << "======================================" << std::endl;
 }
 
 // Check if there's a cycle in the wait graph
 bool DeadlockPrevention::hasCycle() const {
-    std::unordered_set<size_t> visited;
-    std::unordered_set<size_t> recursion_stack;
-
-    for (const auto& [thread_hash, locks] : thread_locks) {
-        if (visited.find(thread_hash) == visited.end()) {
-            if (dfsHasCycle(thread_hash, visited, recursion_stack)) {
-                return true;
-            }
-        }
-    }
-
-    return false;
+    std::lock_guard<std::mutex> lock(wait_graph_mutex);
+    return !findCycles(true).empty();
 }
 
 // Get strategy
@@ -410,15 +698,30 @@ void DeadlockPrevention::resetStatistics() {
     deadlocks_detected = 0;
     deadlocks_prevented = 0;
     transactions_aborted = 0;
+    lock_waits = 0;
+    lock_wait_micros = 0;
+    deadlock_victims = 0;
+    detection_latency_micros = 0;
+    max_detection_latency_micros = 0;
+    optimistic_commits = 0;
+    optimistic_conflicts = 0;
 }
 
-// Get waiting threads
-std::vector<size_t> DeadlockPrevention::getWaitingThreads() const {
-    std::vector<size_t> waiting;
-    for (const auto& [thread_hash, requests] : waiting_requests) {
-        if (!requests.empty()) {
-            waiting.push_back(thread_hash);
-        }
+// Record how an optimistic transfer ended
+void DeadlockPrevention::recordOptimisticOutcome(bool committed) {
+    if (committed) {
+        optimistic_commits++;
+    } else {
+        transactions_aborted++;
+    }
+}
+
+// Get waiting transactions
+std::vector<TransactionHandle> DeadlockPrevention::getWaitingTransactions() const {
+    std::lock_guard<std::mutex> lock(wait_graph_mutex);
+    std::vector<TransactionHandle> waiting;
+    for (uint32_t slot : waiting_slots) {
+        waiting.push_back(slotAt(slot).request.requester);
     }
     return waiting;
 }
@@ -426,8 +729,11 @@ std::vector<size_t> DeadlockPrevention::getWaitingThreads() const {
 // Get locked accounts
 std::vector<int> DeadlockPrevention::getLockedAccounts() const {
     std::vector<int> locked;
-    for (const auto& [account_id, owner] : account_owners) {
-        locked.push_back(account_id);
+    for (size_t i = 0; i < stripe_count; i++) {
+        std::lock_guard<std::mutex> lock(stripes[i].mutex);
+        for (const auto& [account_id, holder] : stripes[i].locks) {
+            locked.push_back(account_id);
+        }
     }
     return locked;
 }
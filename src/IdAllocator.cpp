@@ -0,0 +1,47 @@
+#include "IdAllocator.h"
+#include <iostream>
+#include <limits>
+
+static uint64_t packLease(uint32_t next, uint32_t end) {
+    return (static_cast<uint64_t>(end) << 32) | next;
+}
+
+IdAllocator::IdAllocator(const std::string& sequence, int block_size, BlockReserver reserve_block)
+    : sequence(sequence), block_size(block_size > 0 ? block_size : 1),
+      reserve_block(std::move(reserve_block)), lease(0), blocks_reserved(0) {}
+
+// Take the next id from the lease, reserving a new block when it runs out
+int IdAllocator::next() {
+    while (true) {
+        // The low half never carries into the end: ids stay below 2^31
+        uint64_t taken = lease.fetch_add(1);
+        uint32_t id = static_cast<uint32_t>(taken);
+        uint32_t end = static_cast<uint32_t>(taken >> 32);
+        if (id < end) {
+            return static_cast<int>(id);
+        }
+
+        std::lock_guard<std::mutex> lock(refill_mutex);
+        uint64_t current = lease.load();
+        if (static_cast<uint32_t>(current) < static_cast<uint32_t>(current >> 32)) {
+            continue; // Another thread already refilled the lease
+        }
+
+        int first_id = 0;
+        if (!reserve_block(sequence, block_size, first_id) || first_id <= 0 ||
+            first_id > std::numeric_limits<int>::max() - block_size) {
+            std::cerr << "Failed to reserve ids for sequence " << sequence << std::endl;
+            return -1;
+        }
+
+        // Threads that overshot the old lease retry and land in this one
+        lease.store(packLease(static_cast<uint32_t>(first_id), static_cast<uint32_t>(first_id + block_size)));
+        blocks_reserved++;
+    }
+}
+
+// Forget the current lease; the next allocation reserves a fresh block
+void IdAllocator::reset() {
+    std::lock_guard<std::mutex> lock(refill_mutex);
+    lease.store(0);
+}
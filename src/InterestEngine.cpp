@@ -0,0 +1,49 @@
+#include "InterestEngine.h"
+#include <cmath>
+#include <ctime>
+
+// Interest rates are carried in parts per million
+static const int64_t RATE_SCALE = 1000000;
+static const int64_t DAYS_PER_YEAR = 365;
+
+void InterestSnapshot::add(const std::shared_ptr<Account>& account) {
+    account_ids.push_back(account->getAccountId());
+    balances.push_back(account->getBalance().minorUnits());
+    accounts.push_back(account);
+}
+
+int64_t InterestEngine::rateToPpm(double annual_rate) {
+    return static_cast<int64_t>(std::llround(annual_rate * RATE_SCALE));
+}
+
+// Fixed-point interest kernel.
+// balance * numerator can overflow 64 bits, so the balance is split into whole
+// multiples of the denominator and a remainder: both partial products stay
+// small for rates up to 100% and any balance a 64-bit cent count can hold.
+void InterestEngine::computeInterest(const int64_t* balances, int64_t* interest, size_t count,
+                                     int64_t rate_ppm, int days) {
+    const int64_t numerator = rate_ppm * days;
+    const int64_t denominator = RATE_SCALE * DAYS_PER_YEAR;
+
+    for (size_t i = 0; i < count; i++) {
+        int64_t balance = balances[i] > 0 ? balances[i] : 0;
+        int64_t whole = balance / denominator;
+        int64_t part = (balance % denominator) * numerator;
+        int64_t remainder = part % denominator;
+        interest[i] = whole * numerator + part / denominator + (remainder * 2 >= denominator ? 1 : 0);
+    }
+}
+
+std::string InterestEngine::currentPeriod() {
+    std::time_t now = std::time(nullptr);
+    std::tm local_time{};
+    localtime_r(&now, &local_time);
+
+    char period[8];
+    std::strftime(period, sizeof(period), "%Y-%m", &local_time);
+    return period;
+}
+
+std::string InterestEngine::describePeriod(const std::string& period) {
+    return "Monthly interest " + period;
+}
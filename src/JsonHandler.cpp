@@ -32,7 +32,7 @@ std::string JsonHandler::serializeWithdrawRequest(const WithdrawRequest& request
     ss << "{";
     ss << createJsonString("session_token", request.session_token) << ",";
     ss << createJsonInt("account_id", request.account_id) << ",";
-    ss << createJsonDouble("amount", request.amount);
+    ss << createJsonMoney("amount", request.amount);
     ss << "}";
     return ss.str();
 }
@@ -65,7 +65,7 @@ std::string JsonHandler::serializeBalanceResponse(const BalanceResponse& respons
     ss << "{";
     ss << createJsonBool("success", response.success) << ",";
     ss << createJsonString("message", response.message) << ",";
-    ss << createJsonDouble("balance", response.balance) << ",";
+    ss << createJsonMoney("balance", response.balance) << ",";
     ss << createJsonString("account_type", response.account_type);
     ss << "}";
     return ss.str();
@@ -77,7 +77,7 @@ std::string JsonHandler::serializeWithdrawResponse(const WithdrawResponse& respo
     ss << "{";
     ss << createJsonBool("success", response.success) << ",";
     ss << createJsonString("message", response.message) << ",";
-    ss << createJsonDouble("new_balance", response.new_balance) << ",";
+    ss << createJsonMoney("new_balance", response.new_balance) << ",";
     ss << createJsonString("transaction_id", response.transaction_id);
     ss << "}";
     return ss.str();
@@ -125,7 +125,7 @@ WithdrawRequest JsonHandler::deserializeWithdrawRequest(const std::string& json)
     WithdrawRequest request;
     request.session_token = extractJsonValue(json, "session_token");
     request.account_id = extractJsonInt(json, "account_id");
-    request.amount = extractJsonDouble(json, "amount");
+    request.amount = extractJsonMoney(json, "amount");
     return request;
 }
 
@@ -152,7 +152,7 @@ BalanceResponse JsonHandler::deserializeBalanceResponse(const std::string& json)
     BalanceResponse response;
     response.success = extractJsonBool(json, "success");
     response.message = extractJsonValue(json, "message");
-    response.balance = extractJsonDouble(json, "balance");
+    response.balance = extractJsonMoney(json, "balance");
     response.account_type = extractJsonValue(json, "account_type");
     return response;
 }
@@ -162,7 +162,7 @@ WithdrawResponse JsonHandler::deserializeWithdrawResponse(const std::string& jso
     WithdrawResponse response;
     response.success = extractJsonBool(json, "success");
     response.message = extractJsonValue(json, "message");
-    response.new_balance = extractJsonDouble(json, "new_balance");
+    response.new_balance = extractJsonMoney(json, "new_balance");
     response.transaction_id = extractJsonValue(json, "transaction_id");
     return response;
 }
@@ -220,6 +220,11 @@ std::string JsonHandler::createJsonDouble(const std::string& key, double value)
     return ss.str();
 }
 
+// Money goes on the wire as a plain JSON number with exactly two decimals
+std::string JsonHandler::createJsonMoney(const std::string& key, Money value) {
+    return "\"" + key + "\":" + value.toString();
+}
+
 std::string JsonHandler::createJsonInt(const std::string& key, int value) {
     return "\"" + key + "\":" + std::to_string(value);
 }
@@ -308,6 +313,23 @@ double JsonHandler::extractJsonDouble(const std::string& json, const std::string
     }
 }
 
+// Parse the number text directly so amounts never pass through a double
+Money JsonHandler::extractJsonMoney(const std::string& json, const std::string& key) {
+    std::string search_key = "\"" + key + "\":";
+    size_t start = json.find(search_key);
+    if (start == std::string::npos) return Money();
+
+    start += search_key.length();
+    size_t end = json.find_first_of(",}", start);
+    if (end == std::string::npos) return Money();
+
+    Money value;
+    if (!Money::parse(json.substr(start, end - start), value)) {
+        return Money();
+    }
+    return value;
+}
+
 int JsonHandler::extractJsonInt(const std::string& json, const std::string& key) {
     std::string search_key = "\"" + key + "\":";
     size_t start = json.find(search_key);
@@ -0,0 +1,107 @@
+#include "Money.h"
+#include <cmath>
+#include <cctype>
+#include <limits>
+
+// Round a double amount to the nearest minor unit
+Money Money::fromDouble(double amount) {
+    return Money(static_cast<int64_t>(std::llround(amount * MINOR_UNITS_PER_MAJOR)));
+}
+
+// Parse a decimal amount without going through floating point
+bool Money::parse(const std::string& text, Money& result) {
+    size_t pos = 0;
+    while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) {
+        pos++;
+    }
+
+    bool negative = false;
+    if (pos < text.size() && (text[pos] == '-' || text[pos] == '+')) {
+        negative = text[pos] == '-';
+        pos++;
+    }
+
+    const int64_t max_major = std::numeric_limits<int64_t>::max() / MINOR_UNITS_PER_MAJOR - 1;
+    int64_t major = 0;
+    size_t major_digits = 0;
+    while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos]))) {
+        major = major * 10 + (text[pos] - '0');
+        if (major > max_major) {
+            return false; // Overflow
+        }
+        major_digits++;
+        pos++;
+    }
+
+    int64_t minor = 0;
+    size_t minor_digits = 0;
+    if (pos < text.size() && text[pos] == '.') {
+        pos++;
+        while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos]))) {
+            if (minor_digits == 2) {
+                if (text[pos] != '0') {
+                    return false; // Sub-cent amounts are not representable
+                }
+            } else {
+                minor = minor * 10 + (text[pos] - '0');
+                minor_digits++;
+            }
+            pos++;
+        }
+    }
+
+    while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) {
+        pos++;
+    }
+
+    if ((major_digits == 0 && minor_digits == 0) || pos != text.size()) {
+        return false;
+    }
+
+    if (minor_digits == 1) {
+        minor *= 10; // "4.5" means 4.50
+    }
+
+    int64_t total = major * MINOR_UNITS_PER_MAJOR + minor;
+    result = Money(negative ? -total : total);
+    return true;
+}
+
+// Format with exactly two decimals
+std::string Money::toString() const {
+    // Work in unsigned so INT64_MIN does not overflow on negation
+    uint64_t magnitude = minor_units < 0 ? 0 - static_cast<uint64_t>(minor_units)
+                                         : static_cast<uint64_t>(minor_units);
+    uint64_t cents = magnitude % MINOR_UNITS_PER_MAJOR;
+
+    std::string text = minor_units < 0 ? "-" : "";
+    text += std::to_string(magnitude / MINOR_UNITS_PER_MAJOR);
+    text += '.';
+    text += static_cast<char>('0' + cents / 10);
+    text += static_cast<char>('0' + cents % 10);
+    return text;
+}
+
+// Exact scaling with a 128-bit intermediate
+Money Money::multiplyRatio(int64_t numerator, int64_t denominator) const {
+    if (denominator == 0) {
+        return Money();
+    }
+
+    __int128 product = static_cast<__int128>(minor_units) * numerator;
+    __int128 quotient = product / denominator;
+    __int128 remainder = product % denominator;
+
+    // Round half away from zero
+    __int128 twice_remainder = remainder < 0 ? -remainder * 2 : remainder * 2;
+    __int128 abs_denominator = denominator < 0 ? -static_cast<__int128>(denominator) : denominator;
+    if (twice_remainder >= abs_denominator) {
+        quotient += ((product < 0) != (denominator < 0)) ? -1 : 1;
+    }
+
+    return Money(static_cast<int64_t>(quotient));
+}
+
+std::ostream& operator<<(std::ostream& os, const Money& amount) {
+    return os << amount.toString();
+}
@@ -75,8 +75,9 @@ bool Security::isValidName(const std::string& name) {
 }
 
 // Validate amount
-bool Security::isValidAmount(double amount) {
-    return amount > 0 && amount <= 1000000.0; // Max transaction limit
+bool Security::isValidAmount(Money amount) {
+    return amount >= BankingConstants::MIN_TRANSACTION_AMOUNT &&
+           amount <= BankingConstants::MAX_TRANSACTION_AMOUNT; // Max transaction limit
 }
 
 // Sanitize input
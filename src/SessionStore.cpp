@@ -0,0 +1,206 @@
+#include "SessionStore.h"
+#include <functional>
+#include <iostream>
+
+// ---------------------------------------------------------------------------
+// TimingWheel
+// ---------------------------------------------------------------------------
+
+TimingWheel::TimingWheel() : current_tick(0), scheduled_count(0) {
+}
+
+// Schedule a key to fall due at expiry_tick
+void TimingWheel::schedule(const std::string& key, uint64_t expiry_tick) {
+    if (expiry_tick <= current_tick) {
+        expiry_tick = current_tick + 1; // Already due; fire on the next tick
+    }
+
+    std::vector<std::string> unused;
+    place(Entry{key, expiry_tick}, unused);
+    scheduled_count++;
+}
+
+// Put an entry on the lowest level whose span still contains it.
+// An entry lives on level N while it shares all bits above level N with the
+// current tick, which guarantees its slot is reached before it is due.
+void TimingWheel::place(Entry entry, std::vector<std::string>& expired_keys) {
+    if (entry.expiry_tick <= current_tick) {
+        expired_keys.push_back(std::move(entry.key));
+        scheduled_count--;
+        return;
+    }
+
+    for (size_t level = 0; level < LEVELS; ++level) {
+        size_t span_bits = SLOT_BITS * (level + 1);
+        if ((entry.expiry_tick >> span_bits) == (current_tick >> span_bits)) {
+            size_t slot = (entry.expiry_tick >> (SLOT_BITS * level)) & (SLOTS_PER_LEVEL - 1);
+            slots[level][slot].push_back(std::move(entry));
+            return;
+        }
+    }
+
+    overflow.push_back(std::move(entry));
+}
+
+// Re-place every entry of a slot that the wheel has just reached
+void TimingWheel::cascade(std::vector<Entry>& bucket, std::vector<std::string>& expired_keys) {
+    std::vector<Entry> entries;
+    entries.swap(bucket);
+    for (auto& entry : entries) {
+        place(std::move(entry), expired_keys);
+    }
+}
+
+// Advance one tick at a time, cascading higher levels at their boundaries
+void TimingWheel::advance(uint64_t now_tick, std::vector<std::string>& expired_keys) {
+    while (current_tick < now_tick) {
+        current_tick++;
+
+        // Highest level first so entries can fall through to the slot due now
+        if ((current_tick & ((uint64_t(1) << (SLOT_BITS * LEVELS)) - 1)) == 0) {
+            cascade(overflow, expired_keys);
+        }
+        for (size_t level = LEVELS - 1; level > 0; --level) {
+            uint64_t boundary_mask = (uint64_t(1) << (SLOT_BITS * level)) - 1;
+            if ((current_tick & boundary_mask) == 0) {
+                size_t slot = (current_tick >> (SLOT_BITS * level)) & (SLOTS_PER_LEVEL - 1);
+                cascade(slots[level][slot], expired_keys);
+            }
+        }
+
+        // Everything left in the level 0 slot is due this tick
+        auto& due = slots[0][current_tick & (SLOTS_PER_LEVEL - 1)];
+        for (auto& entry : due) {
+            expired_keys.push_back(std::move(entry.key));
+            scheduled_count--;
+        }
+        due.clear();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// SessionStore
+// ---------------------------------------------------------------------------
+
+// Constructor
+SessionStore::SessionStore(std::chrono::seconds session_ttl, size_t shard_count)
+    : shards(new Shard[shard_count == 0 ? 1 : shard_count]),
+      shard_count(shard_count == 0 ? 1 : shard_count), session_ttl(session_ttl),
+      epoch(std::chrono::steady_clock::now()), stopping(false), sessions_expired(0) {
+    reaper = std::thread(&SessionStore::reaperLoop, this);
+}
+
+// Destructor
+SessionStore::~SessionStore() {
+    {
+        std::lock_guard<std::mutex> lock(reaper_mutex);
+        stopping = true;
+    }
+    reaper_cv.notify_all();
+
+    if (reaper.joinable()) {
+        reaper.join();
+    }
+}
+
+SessionStore::Shard& SessionStore::shardFor(const std::string& token) {
+    return shards[std::hash<std::string>()(token) % shard_count];
+}
+
+// Whole seconds since the wheel epoch, rounded up so a session never expires early
+uint64_t SessionStore::tickFor(std::chrono::steady_clock::time_point time) const {
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(time - epoch).count();
+    if (elapsed <= 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>((elapsed + 999) / 1000);
+}
+
+// Add a new session that expires after the configured timeout
+void SessionStore::insert(const std::string& token, int user_id, const std::string& atm_id) {
+    auto expires_at = std::chrono::steady_clock::now() + session_ttl;
+
+    {
+        Shard& shard = shardFor(token);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.sessions[token] = SessionInfo{user_id, atm_id, expires_at};
+    }
+
+    std::lock_guard<std::mutex> lock(wheel_mutex);
+    wheel.schedule(token, tickFor(expires_at));
+}
+
+// Find a live session; expired sessions are treated as missing even before the reaper runs
+bool SessionStore::lookup(const std::string& token, SessionInfo& info) {
+    Shard& shard = shardFor(token);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.sessions.find(token);
+    if (it == shard.sessions.end() || it->second.expires_at <= std::chrono::steady_clock::now()) {
+        return false;
+    }
+
+    info = it->second;
+    return true;
+}
+
+// Remove a session (its wheel entry is discarded lazily when it falls due)
+bool SessionStore::remove(const std::string& token) {
+    Shard& shard = shardFor(token);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.sessions.erase(token) > 0;
+}
+
+// Count live sessions across all shards
+size_t SessionStore::size() {
+    size_t total = 0;
+    for (size_t i = 0; i < shard_count; ++i) {
+        std::lock_guard<std::mutex> lock(shards[i].mutex);
+        total += shards[i].sessions.size();
+    }
+    return total;
+}
+
+// Drop every session the wheel reports as due
+void SessionStore::reapExpired() {
+    auto now = std::chrono::steady_clock::now();
+    std::vector<std::string> due_tokens;
+    {
+        std::lock_guard<std::mutex> lock(wheel_mutex);
+        uint64_t now_tick = std::chrono::duration_cast<std::chrono::seconds>(now - epoch).count();
+        wheel.advance(now_tick, due_tokens);
+    }
+
+    size_t expired = 0;
+    for (const auto& token : due_tokens) {
+        Shard& shard = shardFor(token);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        // The token may already have been logged out
+        auto it = shard.sessions.find(token);
+        if (it != shard.sessions.end() && it->second.expires_at <= now) {
+            shard.sessions.erase(it);
+            expired++;
+        }
+    }
+
+    if (expired > 0) {
+        sessions_expired += expired;
+        std::cout << "Expired " << expired << " idle session(s)" << std::endl;
+    }
+}
+
+// Reaper thread main loop
+void SessionStore::reaperLoop() {
+    std::unique_lock<std::mutex> lock(reaper_mutex);
+    while (!stopping) {
+        reaper_cv.wait_for(lock, std::chrono::seconds(1), [this]() { return stopping; });
+        if (stopping) {
+            break;
+        }
+
+        lock.unlock();
+        reapExpired();
+        lock.lock();
+    }
+}
@@ -1,4 +1,5 @@
 #include "SyncManager.h"
+#include "BankSystem.h"
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -21,12 +22,12 @@ SyncManager& SyncManager::getInstance() {
 }
 
 // Sync account balance to file
-bool SyncManager::syncAccountBalance(int account_id, double balance) {
+bool SyncManager::syncAccountBalance(int account_id, Money balance) {
     std::lock_guard<std::mutex> lock(sync_mutex);
     
     try {
         // Load existing balances
-        std::unordered_map<int, double> balances;
+        std::unordered_map<int, Money> balances;
         loadAccountBalances(balances);
         
         // Update balance
@@ -41,11 +42,11 @@ bool SyncManager::syncAccountBalance(int account_id, double balance) {
 }
 
 // Get account balance from file
-double SyncManager::getAccountBalance(int account_id) {
+Money SyncManager::getAccountBalance(int account_id) {
     std::lock_guard<std::mutex> lock(sync_mutex);
     
     try {
-        std::unordered_map<int, double> balances;
+        std::unordered_map<int, Money> balances;
         if (loadAccountBalances(balances)) {
             auto it = balances.find(account_id);
             if (it != balances.end()) {
@@ -56,14 +57,14 @@ double SyncManager::getAccountBalance(int account_id) {
         std::cerr << "Error getting account balance: " << e.what() << std::endl;
     }
     
-    return 0.0; // Default balance
+    return Money(); // Default balance
 }
 
 // Check if account exists in sync file
 bool SyncManager::accountExists(int account_id) {
     std::lock_guard<std::mutex> lock(sync_mutex);
     
-    std::unordered_map<int, double> balances;
+    std::unordered_map<int, Money> balances;
     if (loadAccountBalances(balances)) {
         return balances.find(account_id) != balances.end();
     }
@@ -71,30 +72,19 @@ bool SyncManager::accountExists(int account_id) {
     return false;
 }
 
-// Sync transaction to file
+// Sync transaction through the shared transaction journal
 bool SyncManager::syncTransaction(const Transaction& transaction) {
-    std::lock_guard<std::mutex> lock(sync_mutex);
-    
-    try {
-        return saveTransaction(transaction);
-    } catch (const std::exception& e) {
-        std::cerr << "Error syncing transaction: " << e.what() << std::endl;
-        return false;
-    }
+    return BankSystem::getInstance().getJournal().commit(JournalRecord::fromTransaction(transaction));
 }
 
-// Get account transactions from file
+// Get account transactions from the journal's per-account index
 std::vector<std::shared_ptr<Transaction>> SyncManager::getAccountTransactions(int account_id) {
-    std::lock_guard<std::mutex> lock(sync_mutex);
-    
     std::vector<std::shared_ptr<Transaction>> account_transactions;
-    std::vector<std::shared_ptr<Transaction>> all_transactions;
-    
-    if (loadTransactions(all_transactions)) {
-        for (const auto& txn : all_transactions) {
-            if (txn->getFromAccountId() == account_id || txn->getToAccountId() == account_id) {
-                account_transactions.push_back(txn);
-            }
+    std::vector<JournalRecord> records;
+
+    if (BankSystem::getInstance().getJournal().readAccountRecords(account_id, records)) {
+        for (const auto& record : records) {
+            account_transactions.push_back(record.toTransaction());
         }
     }
     
@@ -102,7 +92,7 @@ std::vector<std::shared_ptr<Transaction>> SyncManager::getAccountTransactions(in
 }
 
 // Load account balances from file
-bool SyncManager::loadAccountBalances(std::unordered_map<int, double>& balances) {
+bool SyncManager::loadAccountBalances(std::unordered_map<int, Money>& balances) {
     std::ifstream file(sync_file_path);
     if (!file.is_open()) {
         return true; // File doesn't exist yet, that's okay
@@ -112,8 +102,9 @@ bool SyncManager::loadAccountBalances(std::unordered_map<int, double>& balances)
     while (std::getline(file, line)) {
         std::istringstream iss(line);
         int account_id;
-        double balance;
-        if (iss >> account_id >> balance) {
+        std::string balance_text;
+        Money balance;
+        if (iss >> account_id >> balance_text && Money::parse(balance_text, balance)) {
             balances[account_id] = balance;
         }
     }
@@ -122,14 +113,14 @@ bool SyncManager::loadAccountBalances(std::unordered_map<int, double>& balances)
 }
 
 // Save account balances to file
-bool SyncManager::saveAccountBalances(const std::unordered_map<int, double>& balances) {
+bool SyncManager::saveAccountBalances(const std::unordered_map<int, Money>& balances) {
     std::ofstream file(sync_file_path);
     if (!file.is_open()) {
         return false;
     }
     
     for (const auto& pair : balances) {
-        file << pair.first << " " << std::fixed << std::setprecision(2) << pair.second << std::endl;
+        file << pair.first << " " << pair.second << std::endl;
     }
     
     return true;
@@ -157,7 +148,10 @@ bool SyncManager::loadTransactions(std::vector<std::shared_ptr<Transaction>>& tr
             int txn_id = std::stoi(tokens[0]);
             int from_account = (tokens[1] == "0") ? 0 : std::stoi(tokens[1]);
             int to_account = (tokens[2] == "0") ? 0 : std::stoi(tokens[2]);
-            double amount = std::stod(tokens[3]);
+            Money amount;
+            if (!Money::parse(tokens[3], amount)) {
+                continue;
+            }
             
             TransactionType type = TransactionType::DEPOSIT;
             if (tokens[4] == "WITHDRAWAL") type = TransactionType::WITHDRAWAL;
@@ -187,7 +181,7 @@ bool SyncManager::saveTransaction(const Transaction& transaction) {
     file << transaction.getTransactionId() << "|"
          << transaction.getFromAccountId() << "|"
          << transaction.getToAccountId() << "|"
-         << std::fixed << std::setprecision(2) << transaction.getAmount() << "|"
+         << transaction.getAmount() << "|"
          << transaction.getTypeString() << "|"
          << transaction.getStatusString() << "|"
          << transaction.getDescription() << "|"
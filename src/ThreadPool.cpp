@@ -0,0 +1,100 @@
+#include "ThreadPool.h"
+#include <iostream>
+
+// Constructor
+ThreadPool::ThreadPool(size_t thread_count, size_t max_queue_size)
+    : max_queue_size(max_queue_size == 0 ? 1 : max_queue_size), stopping(false), tasks_completed(0) {
+    if (thread_count == 0) {
+        thread_count = 1;
+    }
+
+    workers.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+// Destructor
+ThreadPool::~ThreadPool() {
+    shutdown();
+}
+
+// Submit a task, waiting for queue space if necessary
+bool ThreadPool::submit(std::function<void()> task) {
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    not_full.wait(lock, [this]() { return stopping || tasks.size() < max_queue_size; });
+
+    if (stopping) {
+        return false;
+    }
+
+    tasks.push_back(std::move(task));
+    lock.unlock();
+    not_empty.notify_one();
+    return true;
+}
+
+// Submit a task only if the queue has space; on failure task is left untouched
+bool ThreadPool::trySubmit(std::function<void()>& task) {
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    if (stopping || tasks.size() >= max_queue_size) {
+        return false;
+    }
+
+    tasks.push_back(std::move(task));
+    lock.unlock();
+    not_empty.notify_one();
+    return true;
+}
+
+// Stop accepting work, drain the queue and join all workers
+void ThreadPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (stopping) {
+            return;
+        }
+        stopping = true;
+    }
+
+    not_empty.notify_all();
+    not_full.notify_all();
+
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+// Get number of tasks waiting in the queue
+size_t ThreadPool::getQueuedTaskCount() {
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    return tasks.size();
+}
+
+// Worker thread main loop
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            not_empty.wait(lock, [this]() { return stopping || !tasks.empty(); });
+
+            if (tasks.empty()) {
+                return; // Stopping and nothing left to run
+            }
+
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        not_full.notify_one();
+
+        try {
+            task();
+        } catch (const std::exception& e) {
+            std::cerr << "Worker task error: " << e.what() << std::endl;
+        }
+        tasks_completed++;
+    }
+}
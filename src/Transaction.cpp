@@ -10,14 +10,14 @@
 // Default constructor
 Transaction::Transaction() 
     : transaction_id(0), from_account_id(0), to_account_id(0), 
-      amount(0.0), type(TransactionType::DEPOSIT), 
+      amount(), type(TransactionType::DEPOSIT), 
       status(TransactionStatus::PENDING) {
     timestamp = getCurrentTimestamp();
 }
 
 // Parameterized constructor
 Transaction::Transaction(int txn_id, int from_account, int to_account, 
-                        double amount, TransactionType type, TransactionStatus status)
+                        Money amount, TransactionType type, TransactionStatus status)
     : transaction_id(txn_id), from_account_id(from_account), to_account_id(to_account),
       amount(amount), type(type), status(status) {
     timestamp = getCurrentTimestamp();
@@ -39,7 +39,7 @@ int Transaction::getToAccountId() const {
     return to_account_id;
 }
 
-double Transaction::getAmount() const {
+Money Transaction::getAmount() const {
     return amount;
 }
 
@@ -72,7 +72,7 @@ void Transaction::setToAccountId(int to_id) {
     to_account_id = to_id;
 }
 
-void Transaction::setAmount(double amount) {
+void Transaction::setAmount(Money amount) {
     this->amount = amount;
 }
 
@@ -88,6 +88,10 @@ void Transaction::setDescription(const std::string& desc) {
     description = desc;
 }
 
+void Transaction::setTimestamp(const std::string& time) {
+    timestamp = time;
+}
+
 // Execute transaction
 bool Transaction::execute() {
     try {
@@ -193,7 +197,7 @@ void Transaction::displayTransaction() const {
     std::cout << "=== Transaction Details ===" << std::endl;
     std::cout << "Transaction ID: " << transaction_id << std::endl;
     std::cout << "Type: " << getTypeString() << std::endl;
-    std::cout << "Amount: $" << std::fixed << std::setprecision(2) << amount << std::endl;
+    std::cout << "Amount: $" << amount << std::endl;
     std::cout << "Status: " << getStatusString() << std::endl;
     std::cout << "Timestamp: " << timestamp << std::endl;
     
@@ -213,25 +217,25 @@ void Transaction::displayTransaction() const {
 std::string Transaction::toString() const {
     std::stringstream ss;
     ss << "TXN-" << transaction_id << " | " << getTypeString() 
-       << " | $" << std::fixed << std::setprecision(2) << amount 
+       << " | $" << amount 
        << " | " << getStatusString() << " | " << timestamp;
     return ss.str();
 }
 
 // Factory methods
-std::shared_ptr<Transaction> Transaction::createDeposit(int account_id, double amount) {
+std::shared_ptr<Transaction> Transaction::createDeposit(int account_id, Money amount) {
     DatabaseHandler& db = DatabaseHandler::getInstance();
     int txn_id = db.getNextTransactionId();
     return std::make_shared<Transaction>(txn_id, 0, account_id, amount, TransactionType::DEPOSIT);
 }
 
-std::shared_ptr<Transaction> Transaction::createWithdrawal(int account_id, double amount) {
+std::shared_ptr<Transaction> Transaction::createWithdrawal(int account_id, Money amount) {
     DatabaseHandler& db = DatabaseHandler::getInstance();
     int txn_id = db.getNextTransactionId();
     return std::make_shared<Transaction>(txn_id, account_id, 0, amount, TransactionType::WITHDRAWAL);
 }
 
-std::shared_ptr<Transaction> Transaction::createTransfer(int from_account, int to_account, double amount) {
+std::shared_ptr<Transaction> Transaction::createTransfer(int from_account, int to_account, Money amount) {
     DatabaseHandler& db = DatabaseHandler::getInstance();
     int txn_id = db.getNextTransactionId();
     return std::make_shared<Transaction>(txn_id, from_account, to_account, amount, TransactionType::TRANSFER);
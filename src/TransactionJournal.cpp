@@ -0,0 +1,695 @@
+#include "TransactionJournal.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+static const char JOURNAL_MAGIC[8] = {'B', 'K', 'J', 'R', 'N', 'L', '0', '1'};
+static const size_t RECORD_HEADER_SIZE = 8;         // Payload length + CRC32
+static const uint32_t MAX_PAYLOAD_SIZE = 64 * 1024; // Anything larger is corruption
+static const size_t INDEX_ENTRY_SIZE = 12;          // Account id + journal offset
+static const int WRITE_ATTEMPTS = 3;                // Tries per batch before its records fail
+static const size_t FAILED_BATCHES_KEPT = 1024;     // Lost batches remembered for late waiters
+
+// CRC-32 (IEEE 802.3), table driven
+static uint32_t crc32(const char* data, size_t length) {
+    static const auto table = []() {
+        std::vector<uint32_t> entries(256);
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                value = (value & 1) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+            }
+            entries[i] = value;
+        }
+        return entries;
+    }();
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; ++i) {
+        crc = table[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Little-endian encoding helpers
+static void putUint(std::string& out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+static uint64_t getUint(const char* data, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+    }
+    return value;
+}
+
+static void putString(std::string& out, const std::string& text) {
+    size_t length = text.size() < 0xFFFF ? text.size() : 0xFFFF;
+    putUint(out, length, 2);
+    out.append(text, 0, length);
+}
+
+static bool getString(const char* data, size_t length, size_t& pos, std::string& text) {
+    if (pos + 2 > length) {
+        return false;
+    }
+    size_t text_length = getUint(data + pos, 2);
+    pos += 2;
+    if (pos + text_length > length) {
+        return false;
+    }
+    text.assign(data + pos, text_length);
+    pos += text_length;
+    return true;
+}
+
+// Read exactly length bytes at offset
+static bool readFully(int fd, char* buffer, size_t length, uint64_t offset) {
+    size_t done = 0;
+    while (done < length) {
+        ssize_t result = ::pread(fd, buffer + done, length - done, static_cast<off_t>(offset + done));
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+// Write the whole buffer, retrying short writes
+static bool writeFully(int fd, const std::string& bytes) {
+    size_t written = 0;
+    while (written < bytes.size()) {
+        ssize_t result = ::write(fd, bytes.data() + written, bytes.size() - written);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        written += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// JournalRecord
+// ---------------------------------------------------------------------------
+
+JournalRecord JournalRecord::fromTransaction(const Transaction& transaction, Kind kind) {
+    return JournalRecord{kind,
+                         transaction.getTransactionId(),
+                         transaction.getFromAccountId(),
+                         transaction.getToAccountId(),
+                         transaction.getAmount(),
+                         transaction.getType(),
+                         transaction.getStatus(),
+                         transaction.getTimestamp(),
+                         transaction.getDescription()};
+}
+
+JournalRecord JournalRecord::checkpoint(int account_id, Money balance) {
+    return JournalRecord{Kind::CHECKPOINT, 0, 0, account_id, balance,
+                         TransactionType::DEPOSIT, TransactionStatus::SUCCESS,
+                         Transaction::getCurrentTimestamp(), ""};
+}
+
+std::shared_ptr<Transaction> JournalRecord::toTransaction() const {
+    auto transaction = std::make_shared<Transaction>(transaction_id, from_account_id, to_account_id,
+                                                     amount, type, status);
+    transaction->setTimestamp(timestamp);
+    transaction->setDescription(description);
+    return transaction;
+}
+
+bool JournalRecord::involvesAccount(int account_id) const {
+    return kind != Kind::CHECKPOINT && (from_account_id == account_id || to_account_id == account_id);
+}
+
+// ---------------------------------------------------------------------------
+// TransactionJournal
+// ---------------------------------------------------------------------------
+
+// Constructor
+TransactionJournal::TransactionJournal(const std::string& path, std::chrono::microseconds group_commit_window)
+    : path(path), fd(-1), index_path(path + ".idx"), index_fd(-1), group_commit_window(group_commit_window),
+      last_lsn(0), completed_lsn(0), stopping(false), broken(false),
+      indexed_end(sizeof(JOURNAL_MAGIC)), records_appended(0), syncs_performed(0) {
+}
+
+// Destructor
+TransactionJournal::~TransactionJournal() {
+    close();
+}
+
+// Recover the valid prefix of the journal and start the writer thread
+bool TransactionJournal::open(std::vector<JournalRecord>& recovered) {
+    if (fd >= 0) {
+        return true;
+    }
+
+    std::string contents;
+    if (!readFile(contents)) {
+        std::cerr << "Failed to read transaction journal " << path << std::endl;
+        return false;
+    }
+
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to open transaction journal " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    std::vector<size_t> offsets;
+    size_t valid_end = sizeof(JOURNAL_MAGIC);
+    if (contents.empty()) {
+        // New journal: the header must be durable before any record depends on it
+        if (!writeFully(fd, std::string(JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC))) || ::fdatasync(fd) != 0) {
+            std::cerr << "Failed to initialize transaction journal " << path << std::endl;
+            ::close(fd);
+            fd = -1;
+            return false;
+        }
+    } else {
+        if (contents.size() < sizeof(JOURNAL_MAGIC) ||
+            std::memcmp(contents.data(), JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0) {
+            std::cerr << path << " is not a transaction journal; refusing to overwrite it" << std::endl;
+            ::close(fd);
+            fd = -1;
+            return false;
+        }
+
+        valid_end = scanRecords(contents, sizeof(JOURNAL_MAGIC), recovered, &offsets);
+        if (valid_end < contents.size()) {
+            // A crash mid-write leaves a torn record; drop it so new records follow valid ones
+            std::cerr << "Discarding " << (contents.size() - valid_end)
+                      << " bytes of incomplete journal tail" << std::endl;
+            if (::ftruncate(fd, static_cast<off_t>(valid_end)) != 0) {
+                std::cerr << "Failed to truncate transaction journal " << path << std::endl;
+                ::close(fd);
+                fd = -1;
+                return false;
+            }
+        }
+        std::cout << "Recovered " << recovered.size() << " journal record(s) from " << path << std::endl;
+    }
+
+    {
+        std::unique_lock<std::shared_mutex> index_lock(index_mutex);
+        if (!openIndex(contents, recovered, offsets, valid_end)) {
+            std::cerr << "Failed to open journal index " << index_path << std::endl;
+            ::close(fd);
+            fd = -1;
+            return false;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = false;
+        broken = false;
+        failed_batches.clear();
+    }
+    writer = std::thread(&TransactionJournal::writerLoop, this);
+    return true;
+}
+
+// Flush pending records and stop the writer
+void TransactionJournal::close() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = true;
+    }
+    queue_cv.notify_all();
+
+    if (writer.joinable()) {
+        writer.join();
+    }
+
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+
+    std::unique_lock<std::shared_mutex> index_lock(index_mutex);
+    if (index_fd >= 0) {
+        ::close(index_fd);
+        index_fd = -1;
+    }
+    account_offsets.clear();
+    indexed_end = sizeof(JOURNAL_MAGIC);
+}
+
+// Queue a record for the writer
+uint64_t TransactionJournal::append(const JournalRecord& record) {
+    // Serialise outside the lock; only the buffer append is serialised
+    std::string bytes;
+    encodeRecord(record, bytes);
+
+    bool wake_writer = false;
+    uint64_t lsn = 0;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (fd < 0 || stopping || broken) {
+            return 0;
+        }
+        wake_writer = pending_bytes.empty();
+        pending_bytes += bytes;
+        lsn = ++last_lsn;
+    }
+
+    records_appended++;
+    if (wake_writer) {
+        queue_cv.notify_one(); // Later appenders join the batch already being formed
+    }
+    return lsn;
+}
+
+// Wait until the writer has synced the given record
+bool TransactionJournal::waitForDurable(uint64_t lsn) {
+    if (lsn == 0) {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    durable_cv.wait(lock, [this, lsn]() { return completed_lsn >= lsn; });
+
+    // Only the batch that held this record matters; later batches may have succeeded
+    for (const auto& [first, last] : failed_batches) {
+        if (lsn >= first && lsn <= last) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Append a record and wait for it to be durable
+bool TransactionJournal::commit(const JournalRecord& record) {
+    return waitForDurable(append(record));
+}
+
+// Read every record in the journal file
+bool TransactionJournal::readAll(std::vector<JournalRecord>& records) const {
+    std::string contents;
+    if (!readFile(contents)) {
+        return false;
+    }
+    if (contents.size() < sizeof(JOURNAL_MAGIC)) {
+        return true; // Nothing written yet
+    }
+
+    scanRecords(contents, sizeof(JOURNAL_MAGIC), records);
+    return true;
+}
+
+// Read one account's history: O(records for that account), not O(journal)
+bool TransactionJournal::readAccountRecords(int account_id, std::vector<JournalRecord>& records) {
+    if (fd < 0) {
+        return false;
+    }
+
+    std::vector<uint64_t> offsets;
+    {
+        std::shared_lock<std::shared_mutex> read_lock = lockCurrentIndex();
+        auto it = account_offsets.find(account_id);
+        if (it != account_offsets.end()) {
+            offsets = it->second;
+        }
+    }
+
+    records.reserve(records.size() + offsets.size());
+    for (uint64_t offset : offsets) {
+        JournalRecord record;
+        if (readRecordAt(offset, record) && record.involvesAccount(account_id)) {
+            records.push_back(std::move(record));
+        }
+    }
+    return true;
+}
+
+// Read up to limit of an account's records, newest first, walking its index backwards
+// from position before (0 = newest). Positions only ever grow because the journal is
+// append-only, so next_before stays valid while new records arrive; it is 0 once the
+// history is exhausted. Reads about limit records no matter how long the history is.
+bool TransactionJournal::readAccountPage(int account_id, size_t limit, uint64_t before,
+                                         std::vector<JournalRecord>& records, uint64_t& next_before) {
+    next_before = 0;
+    if (fd < 0) {
+        return false;
+    }
+
+    std::shared_lock<std::shared_mutex> read_lock = lockCurrentIndex();
+    auto it = account_offsets.find(account_id);
+    if (it == account_offsets.end() || limit == 0) {
+        return true;
+    }
+
+    const std::vector<uint64_t>& offsets = it->second;
+    size_t position = before == 0 || before > offsets.size() ? offsets.size() : static_cast<size_t>(before);
+    size_t taken = 0;
+    while (position > 0) {
+        position--;
+        JournalRecord record;
+        if (!readRecordAt(offsets[position], record) || !record.involvesAccount(account_id)) {
+            continue; // Checkpoints share the index but are not history
+        }
+        if (taken == limit) {
+            next_before = position + 1; // One more record exists past this page
+            break;
+        }
+        records.push_back(std::move(record));
+        taken++;
+    }
+    return true;
+}
+
+// Take index_mutex shared after indexing whatever another process has appended
+std::shared_lock<std::shared_mutex> TransactionJournal::lockCurrentIndex() {
+    struct stat file_info;
+    uint64_t file_size = ::fstat(fd, &file_info) == 0 ? static_cast<uint64_t>(file_info.st_size) : 0;
+
+    std::shared_lock<std::shared_mutex> read_lock(index_mutex);
+    if (file_size > indexed_end) {
+        read_lock.unlock();
+        std::unique_lock<std::shared_mutex> write_lock(index_mutex);
+        catchUpIndex(file_size);
+        write_lock.unlock();
+        read_lock.lock();
+    }
+    return read_lock;
+}
+
+void TransactionJournal::setGroupCommitWindow(std::chrono::microseconds window) {
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    group_commit_window = window;
+}
+
+// Writer thread main loop: one write and one fdatasync per batch
+void TransactionJournal::writerLoop() {
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    while (true) {
+        queue_cv.wait(lock, [this]() { return stopping || !pending_bytes.empty(); });
+        if (pending_bytes.empty()) {
+            break; // Stopping with nothing left to flush
+        }
+
+        // Group commit: give concurrent committers a short window to join this batch
+        if (!stopping && group_commit_window.count() > 0) {
+            queue_cv.wait_for(lock, group_commit_window, [this]() { return stopping; });
+        }
+
+        std::string batch;
+        batch.swap(pending_bytes);
+        uint64_t batch_first = completed_lsn + 1;
+        uint64_t batch_lsn = last_lsn;
+        bool file_intact = !broken;
+        lock.unlock();
+
+        bool written = file_intact && writeBatch(batch, file_intact);
+
+        if (written) {
+            // O_APPEND leaves the position just past this batch, even if another process wrote first
+            off_t end = ::lseek(fd, 0, SEEK_CUR);
+            std::unique_lock<std::shared_mutex> index_lock(index_mutex);
+            if (end >= 0 && static_cast<uint64_t>(end) - batch.size() == indexed_end) {
+                indexBytes(batch, indexed_end);
+            } else if (end >= 0) {
+                catchUpIndex(static_cast<uint64_t>(end));
+            }
+        }
+
+        lock.lock();
+        if (written) {
+            syncs_performed++;
+        } else {
+            failed_batches.emplace_back(batch_first, batch_lsn);
+            if (failed_batches.size() > FAILED_BATCHES_KEPT) {
+                failed_batches.pop_front();
+            }
+            broken = broken || !file_intact;
+        }
+        completed_lsn = batch_lsn;
+        durable_cv.notify_all();
+    }
+}
+
+// Write and sync one batch. A failed attempt is cut back off the file before the
+// next one, so later records never follow a torn batch: open() would truncate
+// them along with it.
+bool TransactionJournal::writeBatch(const std::string& batch, bool& file_intact) {
+    file_intact = true;
+    for (int attempt = 1; attempt <= WRITE_ATTEMPTS; attempt++) {
+        struct stat file_info;
+        if (::fstat(fd, &file_info) != 0) {
+            std::cerr << "Transaction journal stat failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+        if (writeFully(fd, batch) && ::fdatasync(fd) == 0) {
+            return true;
+        }
+        std::cerr << "Transaction journal write failed (attempt " << attempt << " of " << WRITE_ATTEMPTS
+                  << "): " << std::strerror(errno) << std::endl;
+
+        if (::ftruncate(fd, file_info.st_size) != 0 || ::fdatasync(fd) != 0) {
+            std::cerr << "Failed to remove the partial batch from " << path << ": " << std::strerror(errno)
+                      << std::endl;
+            file_intact = false;
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10 * attempt));
+    }
+    return false;
+}
+
+// Load the journal file; a missing file reads as empty
+bool TransactionJournal::readFile(std::string& contents) const {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        contents.clear();
+        return true;
+    }
+
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    contents = buffer.str();
+    return true;
+}
+
+// Read and verify the record stored at offset
+bool TransactionJournal::readRecordAt(uint64_t offset, JournalRecord& record) const {
+    char header[RECORD_HEADER_SIZE];
+    if (!readFully(fd, header, sizeof(header), offset)) {
+        return false;
+    }
+
+    uint32_t length = static_cast<uint32_t>(getUint(header, 4));
+    uint32_t checksum = static_cast<uint32_t>(getUint(header + 4, 4));
+    if (length == 0 || length > MAX_PAYLOAD_SIZE) {
+        return false;
+    }
+
+    std::string payload(length, '\0');
+    return readFully(fd, &payload[0], length, offset + RECORD_HEADER_SIZE) &&
+           crc32(payload.data(), length) == checksum &&
+           decodePayload(payload.data(), length, record);
+}
+
+// Decode records from start, stopping at the first incomplete or corrupt one
+size_t TransactionJournal::scanRecords(const std::string& contents, size_t start,
+                                       std::vector<JournalRecord>& records, std::vector<size_t>* offsets) {
+    size_t pos = start;
+    while (pos + RECORD_HEADER_SIZE <= contents.size()) {
+        const char* header = contents.data() + pos;
+        uint32_t length = static_cast<uint32_t>(getUint(header, 4));
+        uint32_t checksum = static_cast<uint32_t>(getUint(header + 4, 4));
+
+        if (length == 0 || length > MAX_PAYLOAD_SIZE || pos + RECORD_HEADER_SIZE + length > contents.size()) {
+            break;
+        }
+
+        const char* payload = header + RECORD_HEADER_SIZE;
+        JournalRecord record;
+        if (crc32(payload, length) != checksum || !decodePayload(payload, length, record)) {
+            break;
+        }
+
+        records.push_back(std::move(record));
+        if (offsets) {
+            offsets->push_back(pos);
+        }
+        pos += RECORD_HEADER_SIZE + length;
+    }
+    return pos;
+}
+
+// Frame a record as [length][CRC32][payload]
+void TransactionJournal::encodeRecord(const JournalRecord& record, std::string& out) {
+    std::string payload;
+    payload.reserve(40 + record.timestamp.size() + record.description.size());
+    putUint(payload, static_cast<uint8_t>(record.kind), 1);
+    putUint(payload, static_cast<uint32_t>(record.transaction_id), 4);
+    putUint(payload, static_cast<uint32_t>(record.from_account_id), 4);
+    putUint(payload, static_cast<uint32_t>(record.to_account_id), 4);
+    putUint(payload, static_cast<uint64_t>(record.amount.minorUnits()), 8);
+    putUint(payload, static_cast<uint8_t>(record.type), 1);
+    putUint(payload, static_cast<uint8_t>(record.status), 1);
+    putString(payload, record.timestamp);
+    putString(payload, record.description);
+
+    putUint(out, payload.size(), 4);
+    putUint(out, crc32(payload.data(), payload.size()), 4);
+    out += payload;
+}
+
+// Decode one payload whose checksum has already been verified
+bool TransactionJournal::decodePayload(const char* data, size_t length, JournalRecord& record) {
+    const size_t FIXED_SIZE = 1 + 4 + 4 + 4 + 8 + 1 + 1;
+    if (length < FIXED_SIZE) {
+        return false;
+    }
+
+    uint8_t kind = static_cast<uint8_t>(getUint(data, 1));
+    if (kind < static_cast<uint8_t>(JournalRecord::Kind::TRANSACTION) ||
+        kind > static_cast<uint8_t>(JournalRecord::Kind::IMPORTED)) {
+        return false;
+    }
+    uint8_t type = static_cast<uint8_t>(getUint(data + 21, 1));
+    uint8_t status = static_cast<uint8_t>(getUint(data + 22, 1));
+    if (type > static_cast<uint8_t>(TransactionType::INTEREST) ||
+        status > static_cast<uint8_t>(TransactionStatus::PENDING)) {
+        return false;
+    }
+
+    record.kind = static_cast<JournalRecord::Kind>(kind);
+    record.transaction_id = static_cast<int32_t>(getUint(data + 1, 4));
+    record.from_account_id = static_cast<int32_t>(getUint(data + 5, 4));
+    record.to_account_id = static_cast<int32_t>(getUint(data + 9, 4));
+    record.amount = Money::fromMinorUnits(static_cast<int64_t>(getUint(data + 13, 8)));
+    record.type = static_cast<TransactionType>(type);
+    record.status = static_cast<TransactionStatus>(status);
+
+    size_t pos = FIXED_SIZE;
+    return getString(data, length, pos, record.timestamp) &&
+           getString(data, length, pos, record.description) &&
+           pos == length;
+}
+
+// Load the persisted index, keep the entries that match the recovered journal and
+// index whatever the file does not cover yet. A stale or damaged file is rebuilt.
+bool TransactionJournal::openIndex(const std::string& contents, const std::vector<JournalRecord>& records,
+                                   const std::vector<size_t>& offsets, size_t valid_end) {
+    account_offsets.clear();
+    indexed_end = sizeof(JOURNAL_MAGIC);
+
+    std::string entries;
+    std::ifstream index_file(index_path, std::ios::binary);
+    if (index_file.is_open() && !contents.empty()) {
+        std::ostringstream buffer;
+        buffer << index_file.rdbuf();
+        entries = buffer.str();
+    }
+    index_file.close();
+
+    // Keep entries that point at a recovered record involving that account
+    bool rebuild = entries.size() % INDEX_ENTRY_SIZE != 0;
+    size_t covered = 0; // Number of leading records the index already covers
+    for (size_t pos = 0; pos + INDEX_ENTRY_SIZE <= entries.size(); pos += INDEX_ENTRY_SIZE) {
+        int account_id = static_cast<int32_t>(getUint(entries.data() + pos, 4));
+        uint64_t offset = getUint(entries.data() + pos + 4, 8);
+
+        auto it = std::lower_bound(offsets.begin(), offsets.end(), offset);
+        size_t record_index = it - offsets.begin();
+        if (it == offsets.end() || *it != offset || !records[record_index].involvesAccount(account_id)) {
+            rebuild = true;
+            continue;
+        }
+        account_offsets[account_id].push_back(offset);
+        covered = std::max(covered, record_index + 1);
+    }
+
+    for (auto& [account_id, account_entries] : account_offsets) {
+        std::sort(account_entries.begin(), account_entries.end());
+        account_entries.erase(std::unique(account_entries.begin(), account_entries.end()), account_entries.end());
+    }
+    indexed_end = covered < offsets.size() ? offsets[covered] : valid_end;
+
+    if (rebuild) {
+        // Rewrite from the entries we kept; the rest is re-indexed below
+        std::string kept;
+        for (size_t i = 0; i < covered; ++i) {
+            for (int account_id : {records[i].from_account_id, records[i].to_account_id}) {
+                if (account_id > 0 && records[i].involvesAccount(account_id)) {
+                    putUint(kept, static_cast<uint32_t>(account_id), 4);
+                    putUint(kept, offsets[i], 8);
+                }
+            }
+        }
+        index_fd = ::open(index_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+        if (index_fd >= 0 && !writeFully(index_fd, kept)) {
+            return false;
+        }
+    } else {
+        index_fd = ::open(index_path.c_str(), O_WRONLY | O_CREAT | (contents.empty() ? O_TRUNC : 0) | O_APPEND, 0644);
+    }
+    if (index_fd < 0) {
+        return false;
+    }
+
+    if (indexed_end < valid_end) {
+        indexBytes(contents.substr(indexed_end, valid_end - indexed_end), indexed_end);
+    }
+    return true;
+}
+
+// Index the records in bytes, which start at journal offset base, and persist the new entries
+void TransactionJournal::indexBytes(const std::string& bytes, uint64_t base) {
+    std::vector<JournalRecord> records;
+    std::vector<size_t> offsets;
+    size_t consumed = scanRecords(bytes, 0, records, &offsets);
+
+    std::string entries;
+    for (size_t i = 0; i < records.size(); ++i) {
+        const JournalRecord& record = records[i];
+        if (record.kind == JournalRecord::Kind::CHECKPOINT) {
+            continue;
+        }
+        for (int account_id : {record.from_account_id, record.to_account_id}) {
+            if (account_id > 0) {
+                account_offsets[account_id].push_back(base + offsets[i]);
+                putUint(entries, static_cast<uint32_t>(account_id), 4);
+                putUint(entries, base + offsets[i], 8);
+            }
+        }
+    }
+    indexed_end = base + consumed;
+
+    // The index is rebuilt from the journal when needed, so it is never synced
+    if (index_fd >= 0 && !entries.empty() && !writeFully(index_fd, entries)) {
+        std::cerr << "Warning: Failed to update journal index " << index_path << std::endl;
+    }
+}
+
+// Index everything between the indexed prefix and end (records from other processes)
+void TransactionJournal::catchUpIndex(uint64_t end) {
+    if (end <= indexed_end) {
+        return;
+    }
+
+    std::string bytes(end - indexed_end, '\0');
+    if (readFully(fd, &bytes[0], bytes.size(), indexed_end)) {
+        indexBytes(bytes, indexed_end);
+    }
+}
@@ -124,6 +124,9 @@ std::shared_ptr<User> User::registerUser(const std::string& name,
         // Create new user
         std::string hashed_password = hashPassword(password);
         int new_user_id = db.getNextUserId();
+        if (new_user_id <= 0) {
+            return nullptr;
+        }
         
         auto new_user = std::make_shared<User>(new_user_id, name, email, hashed_password);
         
@@ -0,0 +1,141 @@
+#include "WorkStealingScheduler.h"
+#include <iostream>
+
+// Worker the current thread belongs to, if any
+static thread_local const WorkStealingScheduler* current_scheduler = nullptr;
+static thread_local size_t current_worker = 0;
+
+// Constructor
+WorkStealingScheduler::WorkStealingScheduler(size_t thread_count)
+    : queued_tasks(0), sleeping_workers(0), next_queue(0), stopping(false), tasks_executed(0), tasks_stolen(0) {
+    if (thread_count == 0) {
+        thread_count = std::thread::hardware_concurrency();
+    }
+    if (thread_count == 0) {
+        thread_count = 1;
+    }
+
+    queues.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    workers.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers.emplace_back(&WorkStealingScheduler::workerLoop, this, i);
+    }
+}
+
+// Destructor
+WorkStealingScheduler::~WorkStealingScheduler() {
+    shutdown();
+}
+
+// Queue a task on the calling worker's deque, or round-robin from outside the pool
+bool WorkStealingScheduler::submit(Task task) {
+    if (stopping) {
+        return false;
+    }
+
+    size_t index = current_scheduler == this ? current_worker : next_queue++ % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    queued_tasks++;
+    wakeWorker();
+    return true;
+}
+
+// Stop accepting work, run what is queued and join all workers
+void WorkStealingScheduler::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex);
+        if (stopping.exchange(true)) {
+            return;
+        }
+    }
+    work_cv.notify_all();
+
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+// Wake one sleeping worker after queued_tasks went up. A worker counts itself as
+// sleeping before it last checks queued_tasks, so if none is counted here the
+// next one to look will find the task.
+void WorkStealingScheduler::wakeWorker() {
+    if (sleeping_workers == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex);
+    }
+    work_cv.notify_one();
+}
+
+// Take the newest task from a worker's own deque
+bool WorkStealingScheduler::popLocal(size_t index, Task& task) {
+    WorkerQueue& queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+// Take the oldest task from the first other worker that has one
+bool WorkStealingScheduler::steal(size_t thief, Task& task) {
+    for (size_t offset = 1; offset < queues.size(); ++offset) {
+        WorkerQueue& queue = *queues[(thief + offset) % queues.size()];
+        std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || queue.tasks.empty()) {
+            continue; // Busy or empty; try the next victim
+        }
+
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        tasks_stolen++;
+        return true;
+    }
+    return false;
+}
+
+// Worker thread main loop
+void WorkStealingScheduler::workerLoop(size_t index) {
+    current_scheduler = this;
+    current_worker = index;
+
+    while (true) {
+        Task task;
+        if (popLocal(index, task) || steal(index, task)) {
+            queued_tasks--;
+            try {
+                task();
+            } catch (const std::exception& e) {
+                std::cerr << "Worker task error: " << e.what() << std::endl;
+            }
+            tasks_executed++;
+            continue;
+        }
+
+        // A try_lock miss in steal() can pass over a task, so only sleep once none is counted
+        std::unique_lock<std::mutex> lock(idle_mutex);
+        if (queued_tasks > 0) {
+            continue;
+        }
+        if (stopping) {
+            return; // Stopping and nothing left to run
+        }
+
+        sleeping_workers++;
+        work_cv.wait(lock, [this]() { return stopping || queued_tasks > 0; });
+        sleeping_workers--;
+    }
+}
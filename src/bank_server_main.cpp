@@ -3,20 +3,58 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <string>
 #include <signal.h>
+#include <unistd.h>
 
 // Global server instance for signal handling
 BankServer* global_server = nullptr;
 
-// Signal handler for graceful shutdown
+// Signal handler for graceful shutdown (async-signal-safe calls only; start() does the teardown)
 void signalHandler(int signal) {
-    std::cout << "\nReceived signal " << signal << ". Shutting down server..." << std::endl;
+    (void)signal;
+    static const char message[] = "\nReceived shutdown signal. Shutting down server...\n";
+    if (write(STDOUT_FILENO, message, sizeof(message) - 1) < 0) {
+        // Nothing useful to do inside a signal handler
+    }
     if (global_server) {
         global_server->stop();
     }
 }
 
-int main() {
+// Print command line usage
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [--epoll] [--io-threads N] [--workers N]" << std::endl;
+    std::cout << "  --epoll         Multiplex ATMs on epoll I/O threads (default: thread per ATM)" << std::endl;
+    std::cout << "  --io-threads N  Number of epoll I/O threads (reactor mode)" << std::endl;
+    std::cout << "  --workers N     Number of request worker threads (reactor mode)" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    ServerMode mode = ServerMode::THREAD_PER_CLIENT;
+    size_t io_threads = 0;
+    size_t worker_threads = 0;
+
+    // Parse command line arguments
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg == "--epoll") {
+                mode = ServerMode::EPOLL_REACTOR;
+            } else if (arg == "--io-threads" && i + 1 < argc) {
+                io_threads = std::stoul(argv[++i]);
+            } else if (arg == "--workers" && i + 1 < argc) {
+                worker_threads = std::stoul(argv[++i]);
+            } else {
+                printUsage(argv[0]);
+                return arg == "--help" ? 0 : 1;
+            }
+        } catch (...) {
+            std::cerr << "Invalid value for " << arg << std::endl;
+            return 1;
+        }
+    }
+
     std::cout << "=== Banking System Server ===" << std::endl;
     std::cout << "Initializing bank server..." << std::endl;
     
@@ -35,7 +73,13 @@ int main() {
         }
 
         // Create and start server
-        BankServer server(DEFAULT_BANK_PORT);
+        BankServer server(DEFAULT_BANK_PORT, mode);
+        if (io_threads > 0) {
+            server.setIoThreadCount(io_threads);
+        }
+        if (worker_threads > 0) {
+            server.setWorkerThreadCount(worker_threads);
+        }
         global_server = &server;
 
         std::cout << "Bank system initialized successfully" << std::endl;
@@ -81,7 +125,9 @@ int main() {
         if (server_thread.joinable()) {
             server_thread.join();
         }
-        
+        global_server = nullptr;
+
+        bank_system.shutdown();
         std::cout << "Bank server shutdown complete" << std::endl;
         
     } catch (const std::exception& e) {
@@ -11,6 +11,9 @@
 #include "Transaction.h"
 #include "Security.h"
 
+// Transactions shown per page of account history
+static const int HISTORY_PAGE_SIZE = 10;
+
 class BankingCLI {
 private:
     BankSystem& bank_system;
@@ -159,7 +162,7 @@ private:
         for (const auto& account : accounts) {
             std::cout << "Account ID: " << account->getAccountId()
                       << " | Type: " << account->getAccountTypeString()
-                      << " | Balance: $" << std::fixed << std::setprecision(2) << account->getBalance()
+                      << " | Balance: $" << account->getBalance()
                       << std::endl;
         }
     }
@@ -175,7 +178,7 @@ private:
         AccountType type = (type_choice == 1) ? AccountType::SAVINGS : AccountType::CURRENT;
         
         std::cout << "Initial deposit amount: $";
-        double initial_balance = getDoubleInput();
+        Money initial_balance = getMoneyInput();
         
         int account_id = bank_system.createAccount(type, initial_balance);
         if (account_id > 0) {
@@ -189,7 +192,7 @@ private:
         int account_id = getIntInput();
         
         std::cout << "Amount to deposit: $";
-        double amount = getDoubleInput();
+        Money amount = getMoneyInput();
         
         bank_system.deposit(account_id, amount);
     }
@@ -200,7 +203,7 @@ private:
         int account_id = getIntInput();
         
         std::cout << "Amount to withdraw: $";
-        double amount = getDoubleInput();
+        Money amount = getMoneyInput();
         
         bank_system.withdraw(account_id, amount);
     }
@@ -214,7 +217,7 @@ private:
         int to_account = getIntInput();
         
         std::cout << "Amount to transfer: $";
-        double amount = getDoubleInput();
+        Money amount = getMoneyInput();
         
         bank_system.transfer(from_account, to_account, amount);
     }
@@ -229,18 +232,30 @@ private:
 
         std::cout << "\n=== Transaction History ===" << std::endl;
         for (const auto& account : accounts) {
-            std::cout << "Account " << account->getAccountId() << " transactions:" << std::endl;
+            std::cout << "Account " << account->getAccountId() << " transactions (newest first):" << std::endl;
 
-            // Get transactions from BankSystem (which uses the in-memory cache)
-            auto transactions = bank_system.getAccountTransactions(account->getAccountId());
+            // One page at a time, so a long history is never read in full
+            std::string cursor;
+            while (true) {
+                auto page = bank_system.getAccountTransactionPage(account->getAccountId(), HISTORY_PAGE_SIZE, cursor);
+                if (page.transactions.empty() && cursor.empty()) {
+                    std::cout << "  No transactions found." << std::endl;
+                    break;
+                }
 
-            if (transactions.empty()) {
-                std::cout << "  No transactions found." << std::endl;
-            } else {
-                std::cout << "  " << transactions.size() << " transactions found:" << std::endl;
-                for (const auto& txn : transactions) {
+                for (const auto& txn : page.transactions) {
                     std::cout << "    " << txn->toString() << std::endl;
                 }
+                if (page.next_cursor.empty()) {
+                    break;
+                }
+
+                std::cout << "  Show older transactions? (y/n): ";
+                std::string answer = getStringInput();
+                if (answer != "y" && answer != "Y") {
+                    break;
+                }
+                cursor = page.next_cursor;
             }
             std::cout << std::endl;
         }
@@ -276,11 +291,11 @@ private:
         
         // Launch concurrent transfers
         auto future1 = std::async(std::launch::async, [this, acc1, acc2]() {
-            return bank_system.transfer(acc1, acc2, 100.0);
+            return bank_system.transfer(acc1, acc2, Money::fromMajorUnits(100));
         });
         
         auto future2 = std::async(std::launch::async, [this, acc2, acc1]() {
-            return bank_system.transfer(acc2, acc1, 50.0);
+            return bank_system.transfer(acc2, acc1, Money::fromMajorUnits(50));
         });
         
         bool result1 = future1.get();
@@ -296,7 +311,8 @@ private:
         std::cout << "2. View All Users" << std::endl;
         std::cout << "3. View All Accounts" << std::endl;
         std::cout << "4. Deadlock Statistics" << std::endl;
-        std::cout << "5. Back to Main Menu" << std::endl;
+        std::cout << "5. Run Monthly Interest" << std::endl;
+        std::cout << "6. Back to Main Menu" << std::endl;
         std::cout << "Choose an option: ";
         
         int choice = getIntInput();
@@ -315,6 +331,9 @@ private:
                 bank_system.getDeadlockManager().displayStatistics();
                 break;
             case 5:
+                bank_system.runMonthlyInterestJob();
+                break;
+            case 6:
                 break;
             default:
                 std::cout << "Invalid option." << std::endl;
@@ -333,10 +352,11 @@ private:
         return value;
     }
 
-    double getDoubleInput() {
-        double value;
-        while (!(std::cin >> value) || value < 0) {
-            std::cout << "Invalid input. Please enter a positive number: ";
+    Money getMoneyInput() {
+        std::string input;
+        Money value;
+        while (!(std::cin >> input) || !Money::parse(input, value) || value.isNegative()) {
+            std::cout << "Invalid input. Please enter a positive amount (e.g. 25.50): ";
             std::cin.clear();
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         }